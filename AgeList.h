@@ -0,0 +1,79 @@
+#ifndef AGE_LIST_H
+#define AGE_LIST_H
+
+#include "Process.h"
+
+/**
+ * @class AgeList
+ * @brief Intrusive list of resident processes in allocation order, oldest first.
+ *
+ * The links live in the Process itself, so linking and unlinking are O(1) and allocate no
+ * memory. The owner guards the list with its own lock and must unlink a process before it drops
+ * its reference to it.
+ */
+class AgeList
+{
+public:
+    /**
+     * @brief Link a process as the newest entry.
+     * @param process The process that was just allocated.
+     */
+    void pushBack(Process& process)
+    {
+        process.age_older_ = newest_;
+        process.age_newer_ = nullptr;
+        if (newest_)
+        {
+            newest_->age_newer_ = &process;
+        }
+        else
+        {
+            oldest_ = &process;
+        }
+        newest_ = &process;
+        process.age_linked_ = true;
+    }
+
+    /**
+     * @brief Unlink a process. Does nothing if it is not linked.
+     * @param process The process being deallocated.
+     */
+    void remove(Process& process)
+    {
+        if (!process.age_linked_)
+        {
+            return;
+        }
+
+        (process.age_older_ ? process.age_older_->age_newer_ : oldest_) = process.age_newer_;
+        (process.age_newer_ ? process.age_newer_->age_older_ : newest_) = process.age_older_;
+        process.age_older_ = nullptr;
+        process.age_newer_ = nullptr;
+        process.age_linked_ = false;
+    }
+
+    /**
+     * @brief Find the oldest process that can be evicted: not running and not finished.
+     *
+     * At most one process per core is running, so this skips a bounded number of entries.
+     * @return The process, or nullptr if every resident process is running.
+     */
+    Process* findVictim() const
+    {
+        for (Process* process = oldest_; process; process = process->age_newer_)
+        {
+            Process::ProcessState state = process->getState();
+            if (state != Process::RUNNING && state != Process::FINISHED)
+            {
+                return process;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    Process* oldest_ = nullptr; ///< Head of the list.
+    Process* newest_ = nullptr; ///< Tail of the list.
+};
+
+#endif
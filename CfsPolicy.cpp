@@ -0,0 +1,58 @@
+#include "CfsPolicy.h"
+
+namespace
+{
+    const bool registered = PolicyRegistry::add("cfs", [](const PolicyConfig& config)
+    {
+        return std::unique_ptr<SchedulingPolicy>(new CfsPolicy(config));
+    });
+}
+
+/**
+ * @brief Constructor for CfsPolicy.
+ * @param config The policy settings.
+ */
+CfsPolicy::CfsPolicy(const PolicyConfig& config)
+    : QueuedPolicy(config), floors_(new std::atomic<int>[std::max(config.max_cpus, config.num_cpus) + 1]())
+{
+    queues_.setEnterHook([this](Process& process, int core_id)
+    {
+        rebase(process, core_id);
+    });
+}
+
+/**
+ * @brief Measure a process's virtual runtime against the floor of the core it is placed on.
+ * @param process The process being queued on, or stolen to run on, the core.
+ * @param core_id The core.
+ *
+ * The process keeps its distance from the floor of the core it was measured against, or from 0
+ * if it is new.
+ */
+void CfsPolicy::rebase(Process& process, int core_id)
+{
+    int from = process.getVruntimeCore();
+    if (from == core_id)
+    {
+        return;
+    }
+
+    int lag = process.getVirtualRuntime() - (from > 0 ? floors_[from].load() : 0);
+    process.setVirtualRuntime(floors_[core_id].load() + lag);
+    process.setVruntimeCore(core_id);
+}
+
+/**
+ * @brief Print the minimum virtual runtime of each online core.
+ * @param out Output stream to print to.
+ */
+void CfsPolicy::report(std::ostream& out) const
+{
+    out << "------------------------------------------" << std::endl;
+    out << "CFS min vruntime by core:";
+    for (int core_id = 1; core_id <= queues_.getOnlineCores(); ++core_id)
+    {
+        out << "  " << core_id << ": " << floors_[core_id].load();
+    }
+    out << std::endl;
+}
@@ -0,0 +1,138 @@
+#ifndef CFS_POLICY_H
+#define CFS_POLICY_H
+
+#include "QueuedPolicy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <set>
+
+/**
+ * @class VruntimeQueue
+ * @brief Ready processes ordered by virtual runtime in a red-black tree (std::multiset).
+ *
+ * The leftmost process has received the least CPU time. Insertion and removal of the leftmost
+ * entry are O(log n). Ties go to the process that was queued first.
+ */
+class VruntimeQueue
+{
+public:
+    void push(std::shared_ptr<Process> process)
+    {
+        int vruntime = process->getVirtualRuntime();
+        tree_.insert(Entry{vruntime, sequence_++, std::move(process)});
+    }
+
+    std::shared_ptr<Process> pop()
+    {
+        auto leftmost = tree_.begin();
+        std::shared_ptr<Process> process = leftmost->process;
+        tree_.erase(leftmost);
+        return process;
+    }
+
+    size_t size() const
+    {
+        return tree_.size();
+    }
+
+private:
+    /**
+     * @struct Entry
+     * @brief A queued process with its key.
+     */
+    struct Entry
+    {
+        int vruntime;                     ///< Virtual runtime when queued.
+        unsigned long long sequence;      ///< Queue order, for FIFO ties.
+        std::shared_ptr<Process> process; ///< The process.
+
+        bool operator<(const Entry& other) const
+        {
+            if (vruntime != other.vruntime)
+            {
+                return vruntime < other.vruntime;
+            }
+            return sequence < other.sequence;
+        }
+    };
+
+    std::multiset<Entry> tree_;           ///< The tree.
+    unsigned long long sequence_ = 0;     ///< Next queue order number.
+};
+
+/**
+ * @class CfsPolicy
+ * @brief Fair-share scheduling modeled on the Linux Completely Fair Scheduler.
+ *
+ * Every process accumulates virtual runtime as it runs, and each core runs the process with the
+ * least of it for quantum-cycles instructions. Each core keeps its own min_vruntime, a floor that
+ * only ever rises: each pick raises it to the picked process's virtual runtime, which is the least
+ * on that core's queue. A process's virtual runtime is measured against the floor of the core it
+ * is queued on, so when it moves to another core's queue (admission, requeue, steal, rebalance or
+ * drain) it keeps its distance from the floor rather than its raw value: the source floor is
+ * subtracted and the destination floor added. A newcomer starts at the floor of the core that
+ * takes it, so it neither undercuts the processes waiting there nor is starved by them.
+ */
+class CfsPolicy : public QueuedPolicy<CfsPolicy, VruntimeQueue>
+{
+public:
+    /**
+     * @brief Constructor for CfsPolicy.
+     * @param config The policy settings.
+     */
+    explicit CfsPolicy(const PolicyConfig& config);
+
+    void admit(std::shared_ptr<Process> process) override
+    {
+        // Measured against no core yet; the core that takes it adds its floor
+        process->setVirtualRuntime(0);
+        process->setVruntimeCore(0);
+        queues_.admit(std::move(process));
+    }
+
+    void report(std::ostream& out) const override;
+
+    /**
+     * @brief Pick the process with the least virtual runtime and raise the core's min_vruntime to it.
+     * @param core_id The core asking for work.
+     * @return The process, or nullptr if nothing is ready.
+     */
+    std::shared_ptr<Process> pickNext(int core_id)
+    {
+        std::shared_ptr<Process> process = queues_.pop(core_id);
+        if (process)
+        {
+            // min_vruntime only moves forward
+            std::atomic<int>& floor = floors_[core_id];
+            int vruntime = process->getVirtualRuntime();
+            int current = floor.load();
+            while (vruntime > current && !floor.compare_exchange_weak(current, vruntime))
+            {
+            }
+        }
+        return process;
+    }
+
+    /**
+     * @brief Every process gets the same slice; fairness comes from the ordering.
+     * @return The time slice in instructions.
+     */
+    int timeSlice(const Process&, int) const
+    {
+        return std::max(config_.quantum_cycles, 1);
+    }
+
+private:
+    /**
+     * @brief Measure a process's virtual runtime against the floor of the core it is placed on.
+     * @param process The process being queued on, or stolen to run on, the core.
+     * @param core_id The core.
+     */
+    void rebase(Process& process, int core_id);
+
+    std::unique_ptr<std::atomic<int>[]> floors_; ///< min_vruntime of each core, indexed by core ID.
+};
+
+#endif
@@ -1,47 +1,238 @@
 #include "Clock.h"
+#include "CpuAffinity.h"
+
+#include <algorithm>
+#include <cstdlib>
 
 /**
  * @brief Constructor for Clock, initializes clock and active CPU count.
+ * @param mode The clock mode to run in.
+ * @param tickless_idle Stop ticking while there is no runnable work (REAL mode only).
  */
-Clock::Clock() : cpu_clock(0), active_num(0)
+Clock::Clock(ClockMode mode, bool tickless_idle)
+    : cpu_clock(0), active_num(0), mode_(mode), slots_(new TickSlot[MAX_TICK_SLOTS]), slot_count_(0),
+      unparked_(0), park_events_(0), active_cores_(0), tickless_idle_(tickless_idle), runnable_(0), idle_(false)
 {
 }
 
 /**
  * @brief Get the current value of the CPU clock.
  * @return The current value of the CPU clock as an integer.
+ *
+ * While the clock is in tickless idle the value is derived from wall time, so readers still see
+ * time passing even though no ticks are delivered.
  */
 int Clock::getCpuClock()
 {
-    return cpu_clock.load();
+    int now = cpu_clock.load();
+    if (idle_.load())
+    {
+        now = std::max(now, wallTicks());
+    }
+    return now;
 }
 
 /**
- * @brief Start the CPU clock in a separate thread. Increases the clock value every millisecond.
+ * @brief Start the CPU clock in a separate thread. Increases the clock value every millisecond,
+ * or as soon as all participants are parked when running in virtual time.
  */
 void Clock::startCpuClock()
 {
     if (!is_running)
     {
         is_running = true;
+        start_time_ = std::chrono::steady_clock::now();
         std::cout << "CPU Clock started\n";
+
         cpu_clock_thread = std::thread([this]()
         {
-            while (is_running)
+            // Keep the clock off the CPUs the simulated cores are pinned to
+            CpuAffinity::getInstance().pinHousekeeping();
+
+            if (mode_ == VIRTUAL)
             {
-                {
-                    // Lock the mutex to safely increment the clock value
-                    std::lock_guard<std::mutex> lock(clock_mutex);
-                    cpu_clock++;
-                }
+                runVirtual();
+            }
+            else
+            {
+                runReal();
+            }
+        });
+    }
+}
+
+/**
+ * @brief Clock thread body for real time. Ticks once per millisecond.
+ *
+ * Tick n is scheduled at start_time_ + n ms, so the tick count always matches elapsed wall time
+ * and the ticks skipped during tickless idle can be added back exactly.
+ */
+void Clock::runReal()
+{
+    while (is_running)
+    {
+        if (tickless_idle_ && runnable_.load() == 0)
+        {
+            idleUntilWork();
+            continue;
+        }
+
+        int now = ++cpu_clock;
+
+        if (active_cores_.load() > 0)
+        {
+            active_num++;
+        }
+
+        // Wake only the participants whose tick has come
+        deliver(now);
+
+        // Sleep until the next millisecond boundary to simulate clock ticking
+        std::this_thread::sleep_until(start_time_ + std::chrono::milliseconds(now + 1));
+    }
+}
+
+/**
+ * @brief Sleep through a period with no runnable work, waking only for due participants.
+ *
+ * No process is ready or running, so every skipped tick is idle and active_num is left alone.
+ */
+void Clock::idleUntilWork()
+{
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    idle_ = true;
+
+    while (is_running && runnable_.load() == 0)
+    {
+        int seen = idle_events_;
+
+        int count = slot_count_.load();
+        int next = NO_TICK;
+        for (int i = 0; i < count; ++i)
+        {
+            next = std::min(next, slots_[i].target.load());
+        }
+
+        auto woken = [&]
+        {
+            return idle_events_ != seen || !is_running;
+        };
+
+        if (next == NO_TICK)
+        {
+            idle_condition_.wait(lock, woken);
+        }
+        else
+        {
+            idle_condition_.wait_until(lock, start_time_ + std::chrono::milliseconds(next), woken);
+        }
+
+        // Catch up on the skipped ticks and wake whoever is now due
+        int now = wallTicks();
+        if (now > cpu_clock.load())
+        {
+            cpu_clock = now;
+            deliver(now);
+        }
+    }
+
+    idle_ = false;
+}
 
-                // Notify all waiting threads about the clock tick update
-                cycle_condition.notify_all();
+/**
+ * @brief Wake the clock thread out of tickless idle.
+ */
+void Clock::wakeIdleClock()
+{
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        idle_events_++;
+    }
+    idle_condition_.notify_one();
+}
+
+/**
+ * @brief Get the number of whole milliseconds since the clock started.
+ * @return Elapsed wall time in ticks.
+ */
+int Clock::wallTicks() const
+{
+    auto elapsed = std::chrono::steady_clock::now() - start_time_;
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+/**
+ * @brief Clock thread body for virtual time.
+ *
+ * Waits until every registered participant is parked, then jumps straight to the earliest tick
+ * any of them asked for. Skipped ticks are counted as active if any core was running a process,
+ * which is exactly what the per-tick accounting would have recorded.
+ */
+void Clock::runVirtual()
+{
+    while (is_running)
+    {
+        // Read the event sequence first, so any park or resume after this point wakes us
+        int seq = park_events_.load();
+        if (unparked_.load() != 0)
+        {
+            park_events_.wait(seq);
+            continue;
+        }
+
+        // Every participant is parked, so their targets are stable
+        int count = slot_count_.load();
+        int next = NO_TICK;
+        for (int i = 0; i < count; ++i)
+        {
+            next = std::min(next, slots_[i].target.load());
+        }
+
+        if (next == NO_TICK)
+        {
+            // Nobody needs a tick; sleep until someone is resumed
+            park_events_.wait(seq);
+            continue;
+        }
 
-                // Sleep for a millisecond to simulate clock ticking
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        int now = cpu_clock.load();
+        next = std::max(next, now + 1);
+
+        if (active_cores_.load() > 0)
+        {
+            active_num += next - now;
+        }
+
+        // Unpark the released participants before publishing the tick, so none of them can
+        // re-park and let the clock advance again while another is still waking up
+        for (int i = 0; i < count; ++i)
+        {
+            if (slots_[i].target.load() <= next)
+            {
+                unparked_++;
             }
-        });
+        }
+
+        cpu_clock = next;
+        deliver(next);
+    }
+}
+
+/**
+ * @brief Wake every slot whose target has been reached.
+ * @param now The current tick.
+ */
+void Clock::deliver(int now)
+{
+    int count = slot_count_.load();
+    for (int i = 0; i < count; ++i)
+    {
+        TickSlot& slot = slots_[i];
+        if (slot.target.load() <= now)
+        {
+            slot.epoch.store(now);
+            slot.epoch.notify_one();
+        }
     }
 }
 
@@ -51,6 +242,19 @@ void Clock::startCpuClock()
 void Clock::stopCpuClock()
 {
     is_running = false;
+
+    // Wake the clock thread and every waiter so they can observe the stop
+    park_events_++;
+    park_events_.notify_all();
+    wakeIdleClock();
+
+    int count = slot_count_.load();
+    for (int i = 0; i < count; ++i)
+    {
+        slots_[i].epoch++;
+        slots_[i].epoch.notify_all();
+    }
+
     if (cpu_clock_thread.joinable())
     {
         cpu_clock_thread.join();
@@ -69,8 +273,172 @@ std::atomic<int> Clock::getActiveCpuNum()
 
 /**
  * @brief Increment the count of active CPUs.
+ * @param ticks Number of ticks to add.
  */
-void Clock::incrementActiveCpuNum()
+void Clock::incrementActiveCpuNum(int ticks)
 {
-    active_num++;
+    active_num += ticks;
+}
+
+/**
+ * @brief Check whether the clock runs in virtual time.
+ * @return True if the clock is in VIRTUAL mode.
+ */
+bool Clock::isVirtual() const
+{
+    return mode_ == VIRTUAL;
+}
+
+/**
+ * @brief Block until the clock reaches the given tick.
+ * @param slot The caller's tick slot.
+ * @param tick The tick to wait for.
+ * @return The clock value after waking up.
+ *
+ * The target is published before the clock is re-read, and the clock thread publishes the tick
+ * before reading targets, so one of the two always sees the other and no wake-up is lost.
+ */
+int Clock::waitUntil(int slot, int tick)
+{
+    int now = cpu_clock.load();
+    if (now >= tick)
+    {
+        return now;
+    }
+
+    TickSlot& tick_slot = slots_[slot];
+    int seen = tick_slot.epoch.load();
+    tick_slot.target.store(tick);
+
+    if (mode_ == VIRTUAL)
+    {
+        park();
+    }
+    else if (idle_.load())
+    {
+        // An idle clock is only watching the targets it saw when it went to sleep
+        wakeIdleClock();
+    }
+
+    while ((now = cpu_clock.load()) < tick && is_running)
+    {
+        tick_slot.epoch.wait(seen);
+        seen = tick_slot.epoch.load();
+    }
+
+    tick_slot.target.store(NO_TICK);
+    return now;
+}
+
+/**
+ * @brief Register a thread that consumes ticks. Aborts if every tick slot is taken.
+ * @return The tick slot owned by the caller.
+ */
+int Clock::registerParticipant()
+{
+    std::lock_guard<std::mutex> lock(slot_mutex_);
+    unparked_++;
+
+    if (!free_slots_.empty())
+    {
+        int slot = free_slots_.back();
+        free_slots_.pop_back();
+        return slot;
+    }
+
+    int slot = slot_count_.load();
+    if (slot >= MAX_TICK_SLOTS)
+    {
+        // Sharing a slot would corrupt the tick handoff of both threads, so there is no way to go on
+        std::cerr << "Error: Exceeded clock participant limit of " << MAX_TICK_SLOTS << "!" << std::endl;
+        std::abort();
+    }
+
+    slot_count_++;
+    return slot;
+}
+
+/**
+ * @brief Unregister a thread previously added with registerParticipant().
+ * @param slot The tick slot to release.
+ */
+void Clock::unregisterParticipant(int slot)
+{
+    {
+        std::lock_guard<std::mutex> lock(slot_mutex_);
+        slots_[slot].target.store(NO_TICK);
+        free_slots_.push_back(slot);
+    }
+    park();
+}
+
+/**
+ * @brief Park a participant that is blocked on something other than the clock.
+ */
+void Clock::suspendParticipant()
+{
+    if (mode_ == VIRTUAL)
+    {
+        park();
+    }
+}
+
+/**
+ * @brief Unpark a participant previously parked with suspendParticipant().
+ */
+void Clock::resumeParticipant()
+{
+    if (mode_ == VIRTUAL)
+    {
+        unparked_++;
+        park_events_++;
+        park_events_.notify_one();
+    }
+}
+
+/**
+ * @brief Mark a core as running a process.
+ */
+void Clock::markCoreActive()
+{
+    active_cores_++;
+}
+
+/**
+ * @brief Mark a core as no longer running a process.
+ */
+void Clock::markCoreIdle()
+{
+    active_cores_--;
+}
+
+/**
+ * @brief Record that a process became runnable. Wakes a tickless-idle clock.
+ */
+void Clock::addWork()
+{
+    if (runnable_++ == 0 && idle_.load())
+    {
+        wakeIdleClock();
+    }
+}
+
+/**
+ * @brief Record that a runnable process has finished.
+ */
+void Clock::finishWork()
+{
+    runnable_--;
+}
+
+/**
+ * @brief Park the calling participant, waking the virtual clock if it was the last one running.
+ */
+void Clock::park()
+{
+    if (--unparked_ == 0)
+    {
+        park_events_++;
+        park_events_.notify_one();
+    }
 }
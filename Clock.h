@@ -2,19 +2,51 @@
 #define CLOCK_H
 
 #include <atomic>
+#include <chrono>
+#include <climits>
 #include <condition_variable>
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <mutex>
+#include <vector>
 
 /**
  * @class Clock
  * @brief Manages a simulated CPU clock, including tracking active CPUs and providing clock cycle updates.
+ *
+ * In REAL mode the clock advances once every millisecond of wall time. In VIRTUAL mode the clock is
+ * driven as a discrete-event simulation: it only advances once every registered participant is parked,
+ * and then jumps straight to the earliest tick any of them is waiting for.
+ *
+ * Each participant owns a tick slot. Ticks are delivered by writing the slot's epoch and waking only
+ * that slot's owner, so there is no shared mutex or broadcast on the tick path.
+ *
+ * With tickless idle enabled, a REAL clock stops ticking while no process is ready or running and
+ * only wakes for participants whose tick is due. The skipped ticks are added back from wall time.
  */
 class Clock
 {
 public:
-    Clock();
+    /**
+     * @enum ClockMode
+     * @brief How the simulated clock relates to wall time.
+     */
+    enum ClockMode
+    {
+        REAL,      ///< One tick per millisecond of wall time.
+        VIRTUAL    ///< Ticks advance as fast as the participants allow.
+    };
+
+    static constexpr int MAX_TICK_SLOTS = 512;  ///< Maximum number of concurrent participants.
+    static constexpr int NO_TICK = INT_MAX;     ///< Slot target meaning "not waiting".
+
+    /**
+     * @brief Constructor for Clock.
+     * @param mode The clock mode to run in.
+     * @param tickless_idle Stop ticking while there is no runnable work (REAL mode only).
+     */
+    explicit Clock(ClockMode mode = REAL, bool tickless_idle = false);
 
     /**
      * @brief Get the current CPU clock value.
@@ -40,34 +72,136 @@ public:
 
     /**
      * @brief Increment the count of active CPUs.
+     * @param ticks Number of ticks to add.
+     */
+    void incrementActiveCpuNum(int ticks = 1);
+
+    /**
+     * @brief Check whether the clock runs in virtual time.
+     * @return True if the clock is in VIRTUAL mode.
+     */
+    bool isVirtual() const;
+
+    /**
+     * @brief Block until the clock reaches the given tick.
+     * @param slot The caller's tick slot, as returned by registerParticipant().
+     * @param tick The tick to wait for.
+     * @return The clock value after waking up.
+     */
+    int waitUntil(int slot, int tick);
+
+    /**
+     * @brief Register a thread that consumes ticks. The virtual clock waits for all participants.
+     * Aborts if all MAX_TICK_SLOTS slots are taken, since two threads cannot share one.
+     * @return The tick slot owned by the caller.
+     */
+    int registerParticipant();
+
+    /**
+     * @brief Unregister a thread previously added with registerParticipant().
+     * @param slot The tick slot to release.
+     */
+    void unregisterParticipant(int slot);
+
+    /**
+     * @brief Park a participant that is blocked on something other than the clock (e.g. an empty queue).
+     */
+    void suspendParticipant();
+
+    /**
+     * @brief Unpark a participant previously parked with suspendParticipant().
+     */
+    void resumeParticipant();
+
+    /**
+     * @brief Mark a core as running a process. Used for active tick accounting in VIRTUAL mode.
+     */
+    void markCoreActive();
+
+    /**
+     * @brief Mark a core as no longer running a process.
      */
-    void incrementActiveCpuNum();
+    void markCoreIdle();
 
     /**
-     * @brief Accessor to use the condition variable externally.
-     * @return Reference to the condition variable.
+     * @brief Record that a process became runnable. Wakes a tickless-idle clock.
      */
-    std::condition_variable& getCondition() 
-    { 
-        return cycle_condition; 
-    }
+    void addWork();
 
     /**
-     * @brief Accessor to use the mutex externally.
-     * @return Reference to the mutex.
+     * @brief Record that a runnable process has finished.
      */
-    std::mutex& getMutex() 
-    { 
-        return clock_mutex; 
-    }
+    void finishWork();
 
 private:
+    /**
+     * @struct TickSlot
+     * @brief Per-participant tick mailbox, padded to its own cache line.
+     */
+    struct alignas(64) TickSlot
+    {
+        std::atomic<int> target{NO_TICK};  ///< Tick the owner is waiting for.
+        std::atomic<int> epoch{0};         ///< Last tick delivered to the owner.
+    };
+
+    /**
+     * @brief Clock thread body for REAL mode.
+     */
+    void runReal();
+
+    /**
+     * @brief Clock thread body for VIRTUAL mode.
+     */
+    void runVirtual();
+
+    /**
+     * @brief Wake every slot whose target has been reached.
+     * @param now The current tick.
+     */
+    void deliver(int now);
+
+    /**
+     * @brief Park the calling participant, waking the virtual clock if it was the last one running.
+     */
+    void park();
+
+    /**
+     * @brief Sleep through a period with no runnable work, waking only for due participants.
+     */
+    void idleUntilWork();
+
+    /**
+     * @brief Wake the clock thread out of tickless idle.
+     */
+    void wakeIdleClock();
+
+    /**
+     * @brief Get the number of whole milliseconds since the clock started.
+     * @return Elapsed wall time in ticks.
+     */
+    int wallTicks() const;
+
     std::atomic<int> cpu_clock;           ///< The simulated CPU clock counter.
-    bool is_running = false;              ///< Flag to indicate whether the clock is running.
+    std::atomic<bool> is_running = false; ///< Flag to indicate whether the clock is running.
     std::thread cpu_clock_thread;         ///< Thread to simulate the CPU clock.
-    std::condition_variable cycle_condition; ///< Condition variable to notify on each clock tick.
-    std::mutex clock_mutex;               ///< Mutex to protect access to the clock.
     std::atomic<int> active_num;          ///< Number of active CPUs.
+
+    ClockMode mode_;                      ///< REAL or VIRTUAL time.
+    std::unique_ptr<TickSlot[]> slots_;   ///< Tick slots, one per participant.
+    std::atomic<int> slot_count_;         ///< High-water mark of used slots.
+    std::vector<int> free_slots_;         ///< Released slots available for reuse.
+    std::mutex slot_mutex_;               ///< Protects slot registration.
+    alignas(64) std::atomic<int> unparked_; ///< Registered participants that are not parked.
+    std::atomic<int> park_events_;        ///< Bumped whenever the virtual clock may be able to advance.
+    alignas(64) std::atomic<int> active_cores_; ///< Number of cores currently running a process.
+
+    bool tickless_idle_;                  ///< Stop ticking while nothing is runnable.
+    std::chrono::steady_clock::time_point start_time_; ///< Wall time of tick 0 (REAL mode).
+    alignas(64) std::atomic<int> runnable_; ///< Processes that are ready or running.
+    std::atomic<bool> idle_;              ///< Set while the clock is in tickless idle.
+    std::mutex idle_mutex_;               ///< Protects idle_events_.
+    std::condition_variable idle_condition_; ///< Wakes the clock out of tickless idle.
+    int idle_events_ = 0;                 ///< Bumped whenever the idle clock must re-evaluate.
 };
 
 #endif
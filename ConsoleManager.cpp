@@ -1,13 +1,18 @@
 #include "ConsoleManager.h"
+#include "CpuAffinity.h"
+#include "Tracer.h"
 
 #include <iostream>
 #include <cstdlib>
+#include <algorithm>
+#include <sstream>
 
 /**
  * @brief Create a new console session.
  * @param name Name of the console session to be created.
+ * @param deadline Deadline of the process in ticks after arrival, 0 for none.
  */
-void ConsoleManager::createSession(const std::string& name)
+void ConsoleManager::createSession(const std::string& name, int deadline)
 {
     if (screens.find(name) != screens.end())
     {
@@ -18,7 +23,7 @@ void ConsoleManager::createSession(const std::string& name)
     Screen new_screen = {"Process-" + name, 0, 100, screen_manager.getCurrentTimestamp()};
     screens[name] = new_screen;
 
-    process_manager->addProcess(name, screen_manager.getCurrentTimestamp());
+    process_manager->addProcess(name, screen_manager.getCurrentTimestamp(), deadline);
 
     std::cout << "Created screen: " << name << std::endl;
     system("cls");
@@ -29,21 +34,65 @@ void ConsoleManager::createSession(const std::string& name)
 /**
  * @brief Generate a new console session.
  * @param name Name of the console session to be generated.
+ * @param record Instructions, memory and priority from a workload trace, or nullptr to generate them.
+ * @return False if the screen already exists or the process does not fit in memory.
  */
-void ConsoleManager::generateSession(const std::string& name)
+bool ConsoleManager::generateSession(const std::string& name, const WorkloadTrace::Record* record)
 {
     if (screens.find(name) != screens.end())
     {
         std::cout << "Screen '" << name << "' already exists. Reattaching...\n";
-        return;
+        return false;
     }
 
     Screen new_screen = {"Process-" + name, 0, 100, screen_manager.getCurrentTimestamp()};
-    screens[name] = new_screen;
 
-    process_manager->addProcess(name, screen_manager.getCurrentTimestamp());
+    if (!record)
+    {
+        process_manager->addProcess(name, screen_manager.getCurrentTimestamp());
+    }
+    else if (!process_manager->addProcess(name, screen_manager.getCurrentTimestamp(), *record))
+    {
+        std::cerr << "Error: " << name << " needs " << record->memory_kb << " KB but memory is only "
+                  << config.max_mem << " KB. Skipped." << std::endl;
+        return false;
+    }
+    screens[name] = new_screen;
 
     process_manager->getProcess(name);
+    return true;
+}
+
+/**
+ * @brief Admit processes as they arrive, until the arrivals run out or the scheduler-test is stopped.
+ * @param next Gets the next arrival; its arrival tick is relative to start.
+ * @param start The tick arrivals are counted from.
+ * @param tick_slot The generator thread's clock tick slot.
+ * @return Number of processes admitted.
+ */
+long long ConsoleManager::admitArrivals(const std::function<bool(WorkloadTrace::Record&)>& next, int start, int tick_slot)
+{
+    long long admitted = 0;
+    WorkloadTrace::Record record;
+    while (scheduler_running && next(record))
+    {
+        // Wait in short steps so scheduler-stop is not held up by a long gap between arrivals
+        int arrival = start + record.arrival_tick;
+        for (int tick = cpu_clock->getCpuClock(); scheduler_running && tick < arrival;)
+        {
+            tick = cpu_clock->waitUntil(tick_slot, std::min(arrival, tick + 100));
+        }
+        if (!scheduler_running)
+        {
+            break;
+        }
+
+        if (generateSession("Process_" + std::to_string(screens.size()), &record))
+        {
+            admitted++;
+        }
+    }
+    return admitted;
 }
 
 /**
@@ -51,7 +100,7 @@ void ConsoleManager::generateSession(const std::string& name)
  */
 void ConsoleManager::displayAllScreens()
 {
-    screen_manager.displayAllProcess(process_manager->getAllProcess(), num_cpu);
+    screen_manager.displayAllProcess(process_manager->getAllProcess(), config.num_cpu);
 }
 
 /**
@@ -61,7 +110,8 @@ void ConsoleManager::reportUtil()
 {
     // Capture all process output to a stringstream
     std::stringstream output;
-    screen_manager.displayAllProcessToStream(process_manager->getAllProcess(), num_cpu, output);
+    screen_manager.displayAllProcessToStream(process_manager->getAllProcess(), config.num_cpu, output);
+    process_manager->printSchedulingMetrics(output);
 
     // Write the captured output to a file
     std::ofstream out_file("csopesy-log.txt");
@@ -95,31 +145,38 @@ void ConsoleManager::handleCommand(const std::string& command)
     {
         system("cls");
         screen_manager.displayHeader();
-        std::ifstream config_file("config.txt");
-
-        // Temporary variable to skip keys in the file
-        std::string temp;
-
-        if (config_file.is_open())
+        if (config.load("config.txt"))
         {
-            config_file >> temp >> num_cpu;  
-            config_file >> temp >> std::quoted(scheduler);  
-            config_file >> temp >> quantum_cycles;  
-            config_file >> temp >> batch_process_freq;  
-            config_file >> temp >> min_ins;  
-            config_file >> temp >> max_ins;  
-            config_file >> temp >> delays_per_exec;  
-            config_file >> temp >> max_mem;
-            config_file >> temp >> mem_per_frame;
-            config_file >> temp >> min_mem_per_proc;
-            config_file >> temp >> max_mem_per_proc;
+            Tracer::setEnabled(config.trace != 0);
 
-            config_file.close();
+            // Before any thread starts, so each one can pin itself
+            CpuAffinity::getInstance().configure(config.cpu_affinity, config.housekeeping_cpus);
+            if (config.cpu_affinity != "off")
+            {
+                CpuAffinity::getInstance().describe(std::cout);
+            }
 
-            cpu_clock = new Clock();
+            cpu_clock = new Clock(config.clock_mode == "virtual" ? Clock::VIRTUAL : Clock::REAL, config.tickless_idle != 0);
             cpu_clock->startCpuClock();
 
-            process_manager = new ProcessManager(min_ins, max_ins, num_cpu, scheduler, delays_per_exec, quantum_cycles, cpu_clock, max_mem, mem_per_frame, min_mem_per_proc, max_mem_per_proc);
+            // The log has to be open before the first process is admitted
+            if (!config.replay_run.empty() || !config.record_run.empty())
+            {
+                run_log = new RunLog();
+                bool replay = !config.replay_run.empty();
+                if (replay ? !run_log->replay(config.replay_run, config.describeRun(), cpu_clock)
+                           : !run_log->record(config.record_run, config.describeRun(), cpu_clock))
+                {
+                    delete run_log;
+                    run_log = nullptr;
+                }
+                else if (replay)
+                {
+                    std::cout << "Replaying " << config.replay_run << "; scheduler-test feeds in its arrivals\n";
+                }
+            }
+
+            process_manager = new ProcessManager(config.min_ins, config.max_ins, config.num_cpu, config.scheduler, config.delays_per_exec, config.quantum_cycles, cpu_clock, config.max_mem, config.mem_per_frame, config.min_mem_per_proc, config.max_mem_per_proc, config.context_switch_ticks, config.migration_cost_ticks, config.policy_config, config.seed, run_log);
 
             initialized = true;
 
@@ -131,8 +188,25 @@ void ConsoleManager::handleCommand(const std::string& command)
     }
     else if (command.rfind("screen -s ", 0) == 0)
     {
+        // screen -s <name> [-d <deadline ticks>]
         std::string name = command.substr(10);
-        createSession(name);
+        int deadline = 0;
+
+        size_t option = name.find(" -d ");
+        if (option != std::string::npos)
+        {
+            deadline = std::atoi(name.c_str() + option + 4);
+            name = name.substr(0, option);
+        }
+
+        if (option != std::string::npos && deadline <= 0)
+        {
+            std::cerr << "Error: The deadline must be a positive number of ticks." << std::endl;
+        }
+        else
+        {
+            createSession(name, deadline);
+        }
     }
     else if (command.rfind("screen -r ", 0) == 0)
     {
@@ -166,35 +240,60 @@ void ConsoleManager::handleCommand(const std::string& command)
     }
     else if (command == "scheduler-test")
     {
-        if (!scheduler_running)
+        if (!scheduler_running && run_log && run_log->isReplaying())
+        {
+            scheduler_running = true;
+            std::cout << "Run replay started\n";
+
+            scheduler_thread = std::thread([this]()
+            {
+                CpuAffinity::getInstance().pinHousekeeping();
+                int tick_slot = cpu_clock->registerParticipant();
+
+                long long admitted = admitArrivals([this](WorkloadTrace::Record& record)
+                {
+                    return run_log->nextArrival(record);
+                }, cpu_clock->getCpuClock(), tick_slot);
+
+                // The cores replay the rest of the run after the last arrival
+                for (int tick = cpu_clock->getCpuClock(); scheduler_running && run_log->isReplaying();)
+                {
+                    tick = cpu_clock->waitUntil(tick_slot, tick + 100);
+                }
+
+                cpu_clock->unregisterParticipant(tick_slot);
+                std::cout << "Run replay finished: " << admitted << " processes admitted\n";
+                run_log->report(std::cout);
+            });
+        }
+        else if (!scheduler_running)
         {
             scheduler_running = true;
             std::cout << "Scheduler-test started\n";
 
             scheduler_thread = std::thread([this]()
             {
-                int tick_counter = 0;
-                std::unique_lock<std::mutex> lock(cpu_clock->getMutex(), std::defer_lock);
+                // A new process is generated every batch_process_freq ticks. Waiting for that tick
+                // directly lets the virtual clock skip the ticks in between.
+                CpuAffinity::getInstance().pinHousekeeping();
+                int tick_slot = cpu_clock->registerParticipant();
+                int next_batch_tick = cpu_clock->getCpuClock() + std::max(config.batch_process_freq, 1);
 
                 while (scheduler_running)
                 {
-                    lock.lock();
-                    cpu_clock->getCondition().wait(lock);
-                    lock.unlock();
+                    int tick = cpu_clock->waitUntil(tick_slot, next_batch_tick);
 
-                    tick_counter++;
-                    if (tick_counter >= batch_process_freq)
-                    {
-                        tick_counter = 0;
-                        std::string name = "Process_" + std::to_string(screens.size());
-                        generateSession(name);
-                    }
+                    std::string name = "Process_" + std::to_string(screens.size());
+                    generateSession(name);
+                    next_batch_tick = tick + std::max(config.batch_process_freq, 1);
 
-                    if (screens.size() > 4)
+                    if (screens.size() > 4 && !cpu_clock->isVirtual())
                     {
                         std::this_thread::sleep_for(std::chrono::milliseconds(50));
                     }
                 }
+
+                cpu_clock->unregisterParticipant(tick_slot);
             });
         }
         else
@@ -202,11 +301,77 @@ void ConsoleManager::handleCommand(const std::string& command)
             std::cout << "[ERROR] \"scheduler-test\" command is already running\n";
         }
     }
+    else if (command.rfind("workload ", 0) == 0)
+    {
+        // workload <trace file>: replay process arrivals instead of generating them
+        std::string path = command.substr(9);
+        auto trace = std::make_shared<WorkloadTrace>();
+
+        if (scheduler_running)
+        {
+            std::cout << "[ERROR] \"scheduler-test\" command is already running\n";
+        }
+        else if (!trace->open(path))
+        {
+            std::cerr << "Error: Unable to open workload trace " << path << "." << std::endl;
+        }
+        else
+        {
+            scheduler_running = true;
+            std::cout << "Workload replay started\n";
+
+            scheduler_thread = std::thread([this, trace]()
+            {
+                CpuAffinity::getInstance().pinHousekeeping();
+                int tick_slot = cpu_clock->registerParticipant();
+
+                // Records are read one at a time as they arrive, so the trace never has to fit in memory
+                long long admitted = admitArrivals([&trace](WorkloadTrace::Record& record)
+                {
+                    return trace->next(record);
+                }, cpu_clock->getCpuClock(), tick_slot);
+
+                cpu_clock->unregisterParticipant(tick_slot);
+                std::cout << "Workload replay finished: " << admitted << " processes admitted, "
+                          << trace->getSkipped() << " invalid records skipped\n";
+            });
+        }
+    }
+    else if (command.rfind("workload-convert ", 0) == 0)
+    {
+        // workload-convert <csv trace> <binary trace>
+        std::istringstream arguments(command.substr(17));
+        std::string csv_path;
+        std::string binary_path;
+        arguments >> csv_path >> binary_path;
+
+        if (binary_path.empty())
+        {
+            std::cerr << "Error: Usage: workload-convert <csv trace> <binary trace>" << std::endl;
+        }
+        else
+        {
+            long long records = WorkloadTrace::convert(csv_path, binary_path);
+            if (records < 0)
+            {
+                std::cerr << "Error: Unable to convert " << csv_path << " to " << binary_path << "." << std::endl;
+            }
+            else
+            {
+                std::cout << "Wrote " << records << " records to " << binary_path << std::endl;
+            }
+        }
+    }
     else if (command == "scheduler-stop")
     {
         if (scheduler_running)
         {
             scheduler_running = false;
+            if (run_log)
+            {
+                // The rest of the recording would wait for arrivals that will not come
+                run_log->stopReplay();
+            }
             if (scheduler_thread.joinable())
             {
                 scheduler_thread.join();
@@ -226,6 +391,40 @@ void ConsoleManager::handleCommand(const std::string& command)
     {
         process_manager->vmStat();
     }
+    else if (command == "trace-dump" || command.rfind("trace-dump ", 0) == 0)
+    {
+        // trace-dump [file]
+        std::string path = command.size() > 11 ? command.substr(11) : "csopesy-trace.json";
+
+        std::map<int, std::string> names;
+        for (const auto& pair : process_manager->getAllProcess())
+        {
+            names[static_cast<int>(pair.second->getPID())] = pair.first;
+        }
+
+        long long events = Tracer::getInstance().dump(path, names, cpu_clock->getCpuClock());
+        if (events < 0)
+        {
+            std::cerr << "Error: Unable to open " << path << " for writing." << std::endl;
+        }
+        else
+        {
+            std::cout << "Wrote " << events << " trace events to " << path << std::endl;
+        }
+    }
+    else if (command.rfind("set-cores ", 0) == 0)
+    {
+        int cores = std::atoi(command.c_str() + 10);
+        if (cores < 1 || cores > Scheduler::MAX_CORES)
+        {
+            std::cerr << "Error: The number of cores must be between 1 and " << Scheduler::MAX_CORES << "." << std::endl;
+        }
+        else
+        {
+            config.num_cpu = process_manager->setNumCPUs(cores);
+            std::cout << "Cores online: " << config.num_cpu << std::endl;
+        }
+    }
     else if (command == "clear")
     {
         system("cls");
@@ -233,6 +432,11 @@ void ConsoleManager::handleCommand(const std::string& command)
     }
     else if (command == "exit")
     {
+        if (run_log && run_log->isRecording())
+        {
+            run_log->close();
+            run_log->report(std::cout);
+        }
         std::cout << "Exiting..." << std::endl;
         exit(0);
     }
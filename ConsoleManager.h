@@ -4,11 +4,13 @@
 #include "ProcessManager.h"
 #include "ConsoleScreen.h"
 #include "Clock.h"
+#include "EmulatorConfig.h"
 
 #include <string>
 #include <map>
 #include <iostream>
 #include <fstream>
+#include <functional>
 #include <mutex>
 
 /**
@@ -18,20 +20,10 @@
 class ConsoleManager
 {
 private:
-    int num_cpu;                        ///< Number of CPUs
-    std::string scheduler;              ///< Scheduler type used
-    int quantum_cycles;                 ///< Quantum cycles for round-robin scheduling
-    int batch_process_freq;             ///< Frequency of batch process generation
-    int min_ins;                        ///< Minimum instructions per process
-    int max_ins;                        ///< Maximum instructions per process
-    int delays_per_exec;                ///< Number of delays per process execution
+    EmulatorConfig config;              ///< Settings read from config.txt
     bool initialized = false;           ///< Indicates if the console manager has been initialized
     bool scheduler_running = false;     ///< Indicates if the scheduler is running
     Clock* cpu_clock;                ///< Pointer to Clock for timekeeping
-    size_t max_mem;                     ///< Maximum overall memory
-    size_t mem_per_frame;               ///< Memory per frame for paging
-    size_t min_mem_per_proc;            ///< Minimum memory per process
-    size_t max_mem_per_proc;            ///< Maximum memory per process
 
     // Structure for storing screen information
     struct Screen
@@ -45,19 +37,33 @@ private:
     std::map<std::string, Screen> screens; ///< Map to store all screens
     ConsoleScreen screen_manager;          ///< Console screen manager for display operations
     ProcessManager* process_manager;       ///< Pointer to manage processes
+    RunLog* run_log = nullptr;             ///< Log the run is recorded to or replayed from, or nullptr
 
 public:
     /**
      * @brief Create a new console session.
      * @param name Name of the console session to be created.
+     * @param deadline Deadline of the process in ticks after arrival, 0 for none.
      */
-    void createSession(const std::string& name);
+    void createSession(const std::string& name, int deadline = 0);
 
     /**
      * @brief Generate a new console session.
      * @param name Name of the console session to be generated.
+     * @param record Instructions, memory and priority from a workload trace, or nullptr to generate them.
+     * @return False if the screen already exists or the process does not fit in memory.
      */
-    void generateSession(const std::string& name);
+    bool generateSession(const std::string& name, const WorkloadTrace::Record* record = nullptr);
+
+    /**
+     * @brief Admit processes as they arrive, until the arrivals run out or the scheduler-test is stopped.
+     * Runs on the generator thread.
+     * @param next Gets the next arrival; its arrival tick is relative to start.
+     * @param start The tick arrivals are counted from.
+     * @param tick_slot The generator thread's clock tick slot.
+     * @return Number of processes admitted.
+     */
+    long long admitArrivals(const std::function<bool(WorkloadTrace::Record&)>& next, int start, int tick_slot);
 
     /**
      * @brief Display all screens managed by ConsoleManager.
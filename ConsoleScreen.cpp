@@ -74,11 +74,24 @@ void ConsoleScreen::displayAllProcessToStream(std::map<std::string, std::shared_
         }
     }
 
+    // Fairness spread: how far apart the unfinished processes' virtual runtimes are
+    int min_vruntime = 0;
+    int max_vruntime = 0;
+    bool any_unfinished = false;
+
     out << "Existing Screens:" << std::endl;
     for (const auto& pair : process_list)
     {
         const std::shared_ptr<Process> process = pair.second;
 
+        if (process->getState() != Process::FINISHED)
+        {
+            int vruntime = process->getVirtualRuntime();
+            min_vruntime = any_unfinished ? std::min(min_vruntime, vruntime) : vruntime;
+            max_vruntime = any_unfinished ? std::max(max_vruntime, vruntime) : vruntime;
+            any_unfinished = true;
+        }
+
         // Construct the screen listing
         std::stringstream temp;
         temp << std::left << std::setw(30) << process->getName()
@@ -88,14 +101,20 @@ void ConsoleScreen::displayAllProcessToStream(std::map<std::string, std::shared_
         {
             temp << "  Core: " << process->getCPUCoreID() << "   "
                  << process->getCommandCounter() << " / "
-                 << process->getLinesOfCode() << std::endl;
+                 << process->getLinesOfCode()
+                 << "   vruntime: " << process->getVirtualRuntime()
+                 << "   migrations: " << process->getMigrations()
+                 << "   stall: " << process->getMemoryStall() << std::endl;
             running << temp.str() << std::endl;
         }
         if (process->getState() == Process::FINISHED)
         {
             temp << "  FINISHED " << "   "
                  << process->getCommandCounter() << " / "
-                 << process->getLinesOfCode() << std::endl;
+                 << process->getLinesOfCode()
+                 << "   vruntime: " << process->getVirtualRuntime()
+                 << "   migrations: " << process->getMigrations()
+                 << "   stall: " << process->getMemoryStall() << std::endl;
             finished << temp.str() << std::endl;
         }
     }
@@ -103,6 +122,7 @@ void ConsoleScreen::displayAllProcessToStream(std::map<std::string, std::shared_
     out << "CPU utilization: " << (static_cast<double>(core_usage) / num_cpu) * 100 << "%\n";
     out << "Cores used: " << core_usage << "\n";
     out << "Cores available: " << num_cpu - core_usage << "\n";
+    out << "Fairness spread: " << max_vruntime - min_vruntime << " ticks of vruntime across unfinished processes\n";
     out << "------------------------------------------------\n";
     out << "\nRunning Processes: \n"
         << running.str();
@@ -0,0 +1,168 @@
+#include "CoreLoad.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Record a new value of the signal.
+ * @param tick The tick at which the value changed.
+ * @param value The value held from this tick onwards.
+ */
+void LoadAverage::update(int tick, double value)
+{
+    int elapsed = tick - last_tick_.load(std::memory_order_relaxed);
+    double held = value_.load(std::memory_order_relaxed);
+
+    sequence_.fetch_add(1, std::memory_order_acq_rel);
+
+    if (elapsed > 0)
+    {
+        for (int i = 0; i < NUM_WINDOWS; ++i)
+        {
+            // The old value was held for `elapsed` ticks, so decay towards it in one step
+            double decay = std::exp(-static_cast<double>(elapsed) / WINDOW_TICKS[i]);
+            double average = averages_[i].load(std::memory_order_relaxed);
+            averages_[i].store(held + (average - held) * decay, std::memory_order_relaxed);
+        }
+        last_tick_.store(tick, std::memory_order_relaxed);
+    }
+    value_.store(value, std::memory_order_relaxed);
+
+    sequence_.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief Get the averages as of a given tick.
+ * @param tick The current tick.
+ * @return The 1s, 10s and 60s averages.
+ */
+std::array<double, LoadAverage::NUM_WINDOWS> LoadAverage::get(int tick) const
+{
+    std::array<double, NUM_WINDOWS> result{};
+    unsigned before;
+    unsigned after;
+
+    do
+    {
+        before = sequence_.load(std::memory_order_acquire);
+
+        int elapsed = std::max(0, tick - last_tick_.load(std::memory_order_relaxed));
+        double held = value_.load(std::memory_order_relaxed);
+        for (int i = 0; i < NUM_WINDOWS; ++i)
+        {
+            double decay = std::exp(-static_cast<double>(elapsed) / WINDOW_TICKS[i]);
+            result[i] = held + (averages_[i].load(std::memory_order_relaxed) - held) * decay;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = sequence_.load(std::memory_order_relaxed);
+    }
+    while ((before & 1) != 0 || before != after);
+
+    return result;
+}
+
+/**
+ * @brief Mark the core busy or idle.
+ * @param tick The tick at which the state changed.
+ * @param busy True if the core started running a process.
+ */
+void CoreLoad::setBusy(int tick, bool busy)
+{
+    if (busy)
+    {
+        busy_since_.store(tick, std::memory_order_relaxed);
+    }
+    else
+    {
+        int since = busy_since_.exchange(-1, std::memory_order_relaxed);
+        if (since >= 0)
+        {
+            busy_ticks_.fetch_add(tick - since, std::memory_order_relaxed);
+        }
+    }
+
+    utilization_.update(tick, busy ? 1.0 : 0.0);
+}
+
+/**
+ * @brief Get the number of ticks this core has spent running processes.
+ * @param tick The current tick.
+ * @return Busy ticks, including the current busy period.
+ */
+long long CoreLoad::getBusyTicks(int tick) const
+{
+    long long busy_ticks = busy_ticks_.load(std::memory_order_relaxed);
+    int since = busy_since_.load(std::memory_order_relaxed);
+    if (since >= 0 && tick > since)
+    {
+        busy_ticks += tick - since;
+    }
+    return busy_ticks;
+}
+
+/**
+ * @brief Get the decayed utilization of this core.
+ * @param tick The current tick.
+ * @return The 1s, 10s and 60s utilization, between 0 and 1.
+ */
+std::array<double, LoadAverage::NUM_WINDOWS> CoreLoad::getUtilization(int tick) const
+{
+    return utilization_.get(tick);
+}
+
+/**
+ * @brief Record a context switch on this core.
+ * @param ticks Ticks charged for the switch.
+ */
+void CoreLoad::addContextSwitch(int ticks)
+{
+    context_switches_.fetch_add(1, std::memory_order_relaxed);
+    context_switch_ticks_.fetch_add(ticks, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the number of context switches on this core.
+ * @return Context switches so far.
+ */
+long long CoreLoad::getContextSwitches() const
+{
+    return context_switches_.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the ticks this core has spent switching between processes.
+ * @return Context-switch ticks so far.
+ */
+long long CoreLoad::getContextSwitchTicks() const
+{
+    return context_switch_ticks_.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Record a process arriving on this core from another one.
+ * @param ticks Ticks charged for the cold cache.
+ */
+void CoreLoad::addMigration(int ticks)
+{
+    migrations_.fetch_add(1, std::memory_order_relaxed);
+    migration_ticks_.fetch_add(ticks, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the number of processes that migrated to this core.
+ * @return Migrations so far.
+ */
+long long CoreLoad::getMigrations() const
+{
+    return migrations_.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the ticks this core has spent warming its cache for migrated processes.
+ * @return Migration ticks so far.
+ */
+long long CoreLoad::getMigrationTicks() const
+{
+    return migration_ticks_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,120 @@
+#ifndef CORE_LOAD_H
+#define CORE_LOAD_H
+
+#include <array>
+#include <atomic>
+
+/**
+ * @class LoadAverage
+ * @brief Exponentially-decayed averages of a step signal over 1s, 10s and 60s windows.
+ *
+ * The signal (e.g. "core busy" or "run-queue length") is only sampled when it changes, and each
+ * change folds the previous value into the averages for exactly the ticks it was held. This gives
+ * the same result as sampling every tick without needing a sampling thread. Updates must come
+ * from one writer at a time; readers never block the writer.
+ */
+class LoadAverage
+{
+public:
+    static constexpr int NUM_WINDOWS = 3;                               ///< Number of averaging windows.
+    static constexpr std::array<int, NUM_WINDOWS> WINDOW_TICKS = {1000, 10000, 60000}; ///< Window lengths in ticks.
+
+    /**
+     * @brief Record a new value of the signal.
+     * @param tick The tick at which the value changed.
+     * @param value The value held from this tick onwards.
+     */
+    void update(int tick, double value);
+
+    /**
+     * @brief Get the averages as of a given tick.
+     * @param tick The current tick.
+     * @return The 1s, 10s and 60s averages.
+     */
+    std::array<double, NUM_WINDOWS> get(int tick) const;
+
+private:
+    std::atomic<unsigned> sequence_{0};                       ///< Seqlock counter, odd while writing.
+    std::atomic<int> last_tick_{0};                           ///< Tick of the last update.
+    std::atomic<double> value_{0.0};                          ///< Value held since last_tick_.
+    std::array<std::atomic<double>, NUM_WINDOWS> averages_{}; ///< Averages as of last_tick_.
+};
+
+/**
+ * @class CoreLoad
+ * @brief Busy-tick counter and utilization averages for one simulated core.
+ *
+ * Written only by the worker thread that owns the core, and padded to a cache line so cores
+ * never share one.
+ */
+class alignas(64) CoreLoad
+{
+public:
+    /**
+     * @brief Mark the core busy or idle.
+     * @param tick The tick at which the state changed.
+     * @param busy True if the core started running a process.
+     */
+    void setBusy(int tick, bool busy);
+
+    /**
+     * @brief Get the number of ticks this core has spent running processes.
+     * @param tick The current tick.
+     * @return Busy ticks, including the current busy period.
+     */
+    long long getBusyTicks(int tick) const;
+
+    /**
+     * @brief Get the decayed utilization of this core.
+     * @param tick The current tick.
+     * @return The 1s, 10s and 60s utilization, between 0 and 1.
+     */
+    std::array<double, LoadAverage::NUM_WINDOWS> getUtilization(int tick) const;
+
+    /**
+     * @brief Record a context switch on this core.
+     * @param ticks Ticks charged for the switch.
+     */
+    void addContextSwitch(int ticks);
+
+    /**
+     * @brief Get the number of context switches on this core.
+     * @return Context switches so far.
+     */
+    long long getContextSwitches() const;
+
+    /**
+     * @brief Get the ticks this core has spent switching between processes.
+     * @return Context-switch ticks so far.
+     */
+    long long getContextSwitchTicks() const;
+
+    /**
+     * @brief Record a process arriving on this core from another one.
+     * @param ticks Ticks charged for the cold cache.
+     */
+    void addMigration(int ticks);
+
+    /**
+     * @brief Get the number of processes that migrated to this core.
+     * @return Migrations so far.
+     */
+    long long getMigrations() const;
+
+    /**
+     * @brief Get the ticks this core has spent warming its cache for migrated processes.
+     * @return Migration ticks so far.
+     */
+    long long getMigrationTicks() const;
+
+private:
+    std::atomic<long long> busy_ticks_{0};  ///< Ticks of completed busy periods.
+    std::atomic<int> busy_since_{-1};       ///< Start of the current busy period, or -1 if idle.
+    std::atomic<long long> context_switches_{0};   ///< Context switches so far.
+    std::atomic<long long> context_switch_ticks_{0}; ///< Ticks charged for context switches.
+    std::atomic<long long> migrations_{0};         ///< Processes that migrated to this core.
+    std::atomic<long long> migration_ticks_{0};    ///< Ticks charged for migrations.
+    LoadAverage utilization_;               ///< Decayed busy fraction.
+};
+
+#endif
@@ -0,0 +1,342 @@
+#include "CpuAffinity.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+    /**
+     * @brief Order CPUs grouped by physical core: every core's first thread, then every core's second, and so on.
+     * @param cores Hardware threads of each physical core, in core order.
+     * @return The CPUs in placement order.
+     */
+    std::vector<int> interleave(const std::vector<std::vector<int>>& cores)
+    {
+        std::vector<int> order;
+        for (size_t thread = 0;; ++thread)
+        {
+            size_t added = 0;
+            for (const std::vector<int>& siblings : cores)
+            {
+                if (thread < siblings.size())
+                {
+                    order.push_back(siblings[thread]);
+                    added++;
+                }
+            }
+            if (added == 0)
+            {
+                return order;
+            }
+        }
+    }
+
+#ifdef __linux__
+    /**
+     * @brief Read one integer from a sysfs file.
+     * @param path The file.
+     * @param fallback Returned if the file cannot be read.
+     * @return The value.
+     */
+    int readSysInt(const std::string& path, int fallback)
+    {
+        std::ifstream file(path);
+        int value;
+        return (file >> value) ? value : fallback;
+    }
+
+    /**
+     * @brief Parse a sysfs CPU list such as "0-3,6".
+     * @param list The list.
+     * @return The CPUs.
+     */
+    std::vector<int> parseRanges(const std::string& list)
+    {
+        std::vector<int> cpus;
+        std::istringstream stream(list);
+        for (std::string range; std::getline(stream, range, ',');)
+        {
+            int first = 0;
+            int last = 0;
+            char dash;
+            std::istringstream range_stream(range);
+            if (!(range_stream >> first))
+            {
+                continue;
+            }
+            last = (range_stream >> dash >> last) ? last : first;
+            for (int cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+#endif
+}
+
+/**
+ * @brief Get the singleton instance of CpuAffinity.
+ * @return Reference to the singleton CpuAffinity instance.
+ */
+CpuAffinity& CpuAffinity::getInstance()
+{
+    static CpuAffinity instance;
+    return instance;
+}
+
+/**
+ * @brief Set up the placement from the config values.
+ * @param mode "off", "auto" or a space-separated list of host CPUs for the workers.
+ * @param housekeeping Space-separated list of host CPUs for the other threads, or empty.
+ */
+void CpuAffinity::configure(const std::string& mode, const std::string& housekeeping)
+{
+    std::lock_guard<std::mutex> lock(affinity_mutex_);
+    worker_cpus_.clear();
+    housekeeping_cpus_.clear();
+
+    if (mode.empty() || mode == "off")
+    {
+        return;
+    }
+
+    std::vector<int> host = hostTopology();
+
+    if (mode == "auto")
+    {
+        // Pinning to the only CPU there is changes nothing
+        if (host.size() < 2)
+        {
+            return;
+        }
+        worker_cpus_.assign(host.begin(), host.end() - 1);
+        housekeeping_cpus_.push_back(host.back());
+    }
+    else
+    {
+        worker_cpus_ = parseList(mode);
+        if (worker_cpus_.empty())
+        {
+            std::cerr << "Error: Invalid cpu-affinity '" << mode << "', expected off, auto or a list of host CPUs." << std::endl;
+            return;
+        }
+
+        for (int cpu : host)
+        {
+            if (std::find(worker_cpus_.begin(), worker_cpus_.end(), cpu) == worker_cpus_.end())
+            {
+                housekeeping_cpus_.push_back(cpu);
+            }
+        }
+    }
+
+    if (!housekeeping.empty())
+    {
+        housekeeping_cpus_ = parseList(housekeeping);
+    }
+}
+
+/**
+ * @brief Pin the calling thread to the host CPU of a simulated core. No-op when off.
+ * @param core_id The simulated core ID (starting at 1).
+ */
+void CpuAffinity::pinCore(int core_id)
+{
+    int cpu = getHostCpu(core_id);
+    if (cpu >= 0 && !pinThread({cpu}))
+    {
+        std::cerr << "Error: Unable to pin core " << core_id << " to host CPU " << cpu << "." << std::endl;
+    }
+}
+
+/**
+ * @brief Pin the calling thread to the housekeeping CPUs. No-op when off or none are left.
+ */
+void CpuAffinity::pinHousekeeping()
+{
+    std::vector<int> cpus;
+    {
+        std::lock_guard<std::mutex> lock(affinity_mutex_);
+        cpus = housekeeping_cpus_;
+    }
+
+    if (!cpus.empty() && !pinThread(cpus))
+    {
+        std::cerr << "Error: Unable to pin a housekeeping thread to its host CPUs." << std::endl;
+    }
+}
+
+/**
+ * @brief Get the host CPU a simulated core is pinned to.
+ * @param core_id The simulated core ID (starting at 1).
+ * @return The host CPU, or -1 when pinning is off.
+ */
+int CpuAffinity::getHostCpu(int core_id) const
+{
+    std::lock_guard<std::mutex> lock(affinity_mutex_);
+    if (worker_cpus_.empty() || core_id < 1)
+    {
+        return -1;
+    }
+    return worker_cpus_[(core_id - 1) % worker_cpus_.size()];
+}
+
+/**
+ * @brief Print the worker and housekeeping CPUs, or that pinning is off.
+ * @param out Output stream to print to.
+ */
+void CpuAffinity::describe(std::ostream& out) const
+{
+    std::lock_guard<std::mutex> lock(affinity_mutex_);
+    if (worker_cpus_.empty())
+    {
+        out << "CPU affinity: off" << std::endl;
+        return;
+    }
+
+    out << "CPU affinity: cores on host CPUs";
+    for (int cpu : worker_cpus_)
+    {
+        out << " " << cpu;
+    }
+    out << "; housekeeping on";
+    if (housekeeping_cpus_.empty())
+    {
+        out << " any CPU";
+    }
+    for (int cpu : housekeeping_cpus_)
+    {
+        out << " " << cpu;
+    }
+    out << std::endl;
+}
+
+/**
+ * @brief List the online host CPUs, physical cores first and SMT siblings after.
+ * @return Host CPU numbers; 0 to hardware_concurrency - 1 if the topology is unknown.
+ */
+std::vector<int> CpuAffinity::hostTopology()
+{
+    std::vector<std::vector<int>> cores;
+
+#ifdef _WIN32
+    DWORD length = 0;
+    GetLogicalProcessorInformation(nullptr, &length);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!info.empty() && GetLogicalProcessorInformation(info.data(), &length))
+    {
+        for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& entry : info)
+        {
+            if (entry.Relationship != RelationProcessorCore)
+            {
+                continue;
+            }
+
+            std::vector<int> siblings;
+            for (int cpu = 0; cpu < static_cast<int>(sizeof(ULONG_PTR) * 8); ++cpu)
+            {
+                if (entry.ProcessorMask & (static_cast<ULONG_PTR>(1) << cpu))
+                {
+                    siblings.push_back(cpu);
+                }
+            }
+            cores.push_back(siblings);
+        }
+    }
+#elif defined(__linux__)
+    std::ifstream online("/sys/devices/system/cpu/online");
+    std::string list;
+    if (std::getline(online, list))
+    {
+        // Keyed on (package, core) so the cores of one package stay together
+        std::map<std::pair<int, int>, std::vector<int>> by_core;
+        for (int cpu : parseRanges(list))
+        {
+            std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+            int package = readSysInt(topology + "physical_package_id", 0);
+            int core = readSysInt(topology + "core_id", cpu);
+            by_core[{package, core}].push_back(cpu);
+        }
+        for (auto& entry : by_core)
+        {
+            cores.push_back(std::move(entry.second));
+        }
+    }
+#endif
+
+    std::vector<int> order = interleave(cores);
+    if (order.empty())
+    {
+        for (int cpu = 0; cpu < static_cast<int>(std::thread::hardware_concurrency()); ++cpu)
+        {
+            order.push_back(cpu);
+        }
+    }
+    return order;
+}
+
+/**
+ * @brief Pin the calling thread to a set of host CPUs.
+ * @param cpus The host CPUs.
+ * @return True if the host accepted the mask.
+ */
+bool CpuAffinity::pinThread(const std::vector<int>& cpus)
+{
+#ifdef _WIN32
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus)
+    {
+        if (cpu >= 0 && cpu < static_cast<int>(sizeof(DWORD_PTR) * 8))
+        {
+            mask |= static_cast<DWORD_PTR>(1) << cpu;
+        }
+    }
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus)
+    {
+        if (cpu >= 0 && cpu < CPU_SETSIZE)
+        {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return CPU_COUNT(&set) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+/**
+ * @brief Parse a space-separated list of host CPUs.
+ * @param list The list.
+ * @return The CPUs, without entries that are not numbers.
+ */
+std::vector<int> CpuAffinity::parseList(const std::string& list)
+{
+    std::vector<int> cpus;
+    std::istringstream stream(list);
+    for (std::string entry; stream >> entry;)
+    {
+        if (!entry.empty() && std::all_of(entry.begin(), entry.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        {
+            cpus.push_back(std::atoi(entry.c_str()));
+        }
+    }
+    return cpus;
+}
@@ -0,0 +1,103 @@
+#ifndef CPU_AFFINITY_H
+#define CPU_AFFINITY_H
+
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class CpuAffinity
+ * @brief Places the emulator's threads on host CPUs, in a singleton pattern.
+ *
+ * Off by default, in which case the host OS places every thread. When configured, the worker
+ * thread of simulated core N is pinned to one host CPU and the clock and process-generator
+ * threads are pinned to the remaining "housekeeping" CPUs, so they never take a worker's cache.
+ *
+ * The `cpu-affinity` config key takes:
+ * - "off": no pinning.
+ * - "auto": derive the order from the host topology. Each physical core's first hardware thread
+ *   comes first, then the SMT siblings, so simulated cores spread over physical cores before
+ *   doubling up. The last CPU in that order is kept for housekeeping.
+ * - a space-separated list of host CPUs, e.g. "0 2 4 6": core N goes to the N-th entry,
+ *   wrapping around when there are more cores than entries.
+ *
+ * `housekeeping-cpus` overrides the housekeeping CPUs with a list of its own. Without it, an
+ * explicit list leaves housekeeping on every host CPU the workers do not use.
+ */
+class CpuAffinity
+{
+public:
+    /**
+     * @brief Get the singleton instance of CpuAffinity.
+     * @return Reference to the singleton CpuAffinity instance.
+     */
+    static CpuAffinity& getInstance();
+
+    /**
+     * @brief Set up the placement from the config values.
+     * @param mode "off", "auto" or a space-separated list of host CPUs for the workers.
+     * @param housekeeping Space-separated list of host CPUs for the other threads, or empty.
+     */
+    void configure(const std::string& mode, const std::string& housekeeping);
+
+    /**
+     * @brief Pin the calling thread to the host CPU of a simulated core. No-op when off.
+     * @param core_id The simulated core ID (starting at 1).
+     */
+    void pinCore(int core_id);
+
+    /**
+     * @brief Pin the calling thread to the housekeeping CPUs. No-op when off or none are left.
+     */
+    void pinHousekeeping();
+
+    /**
+     * @brief Get the host CPU a simulated core is pinned to.
+     * @param core_id The simulated core ID (starting at 1).
+     * @return The host CPU, or -1 when pinning is off.
+     */
+    int getHostCpu(int core_id) const;
+
+    /**
+     * @brief Print the worker and housekeeping CPUs, or that pinning is off.
+     * @param out Output stream to print to.
+     */
+    void describe(std::ostream& out) const;
+
+    /**
+     * @brief List the online host CPUs, physical cores first and SMT siblings after.
+     * @return Host CPU numbers; 0 to hardware_concurrency - 1 if the topology is unknown.
+     */
+    static std::vector<int> hostTopology();
+
+private:
+    /**
+     * @brief Private constructor for singleton pattern.
+     */
+    CpuAffinity() = default;
+
+    // Disable copy constructor and assignment operator to enforce Singleton pattern.
+    CpuAffinity(const CpuAffinity&) = delete;
+    CpuAffinity& operator=(const CpuAffinity&) = delete;
+
+    /**
+     * @brief Pin the calling thread to a set of host CPUs.
+     * @param cpus The host CPUs.
+     * @return True if the host accepted the mask.
+     */
+    static bool pinThread(const std::vector<int>& cpus);
+
+    /**
+     * @brief Parse a space-separated list of host CPUs.
+     * @param list The list.
+     * @return The CPUs, without entries that are not numbers.
+     */
+    static std::vector<int> parseList(const std::string& list);
+
+    std::vector<int> worker_cpus_;        ///< Host CPU of each simulated core, wrapping around.
+    std::vector<int> housekeeping_cpus_;  ///< Host CPUs of the clock and generator threads.
+    mutable std::mutex affinity_mutex_;   ///< Guards the CPU lists.
+};
+
+#endif
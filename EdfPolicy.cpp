@@ -0,0 +1,206 @@
+#include "EdfPolicy.h"
+
+#include "Clock.h"
+
+#include <iomanip>
+
+namespace
+{
+    const bool registered = PolicyRegistry::add("edf", [](const PolicyConfig& config)
+    {
+        return std::unique_ptr<SchedulingPolicy>(new EdfPolicy(config));
+    });
+}
+
+/**
+ * @brief Give a process the default deadline if it has none, then run the admission test.
+ * @param process The new process.
+ */
+void EdfPolicy::admit(std::shared_ptr<Process> process)
+{
+    if (process->getDeadline() == 0)
+    {
+        process->setDeadline(std::max(config_.edf_deadline_ticks, 0));
+    }
+
+    if (process->getDeadline() > 0)
+    {
+        double needed = density(*process);
+
+        std::lock_guard<std::mutex> lock(admission_mutex_);
+        double largest = densities_.empty() ? needed : std::max(needed, *densities_.rbegin());
+        if (needed <= 1.0 && density_ + needed <= densityBound(largest))
+        {
+            density_ += needed;
+            densities_.insert(needed);
+            admitted_++;
+        }
+        else
+        {
+            process->setDeadline(0);
+            rejected_++;
+        }
+    }
+
+    if (process->getDeadline() > 0)
+    {
+        std::lock_guard<std::mutex> lock(deadline_mutex_);
+        deadlines_.push(std::move(process));
+    }
+    else
+    {
+        queues_.admit(std::move(process));
+    }
+}
+
+/**
+ * @brief Put back a process that was picked but could not run.
+ * @param process The process.
+ * @param core_id The core whose queue takes it if it has no deadline.
+ */
+void EdfPolicy::resume(std::shared_ptr<Process> process, int core_id)
+{
+    if (process->getDeadline() > 0)
+    {
+        std::lock_guard<std::mutex> lock(deadline_mutex_);
+        deadlines_.push(std::move(process));
+    }
+    else
+    {
+        queues_.push(std::move(process), core_id);
+    }
+}
+
+/**
+ * @brief Queue a preempted process again: by deadline if it has one, on its core otherwise.
+ * @param process The preempted process.
+ * @param core_id The core it ran on.
+ * @param ticks Ticks it ran for.
+ */
+void EdfPolicy::requeue(std::shared_ptr<Process> process, int core_id, int ticks)
+{
+    (void)ticks;
+
+    if (process->getDeadline() > 0)
+    {
+        std::lock_guard<std::mutex> lock(deadline_mutex_);
+        deadlines_.push(std::move(process));
+    }
+    else
+    {
+        queues_.requeue(std::move(process), core_id);
+    }
+}
+
+/**
+ * @brief Check whether a process with a deadline or a best-effort process is waiting.
+ * @return True if some process is ready.
+ */
+bool EdfPolicy::hasWork() const
+{
+    {
+        std::lock_guard<std::mutex> lock(deadline_mutex_);
+        if (deadlines_.size() > 0)
+        {
+            return true;
+        }
+    }
+    return queues_.any();
+}
+
+/**
+ * @brief Record whether a process met its deadline and release its share of the cores.
+ * @param process The finished process.
+ * @param core_id The core it ran on.
+ * @param ticks Ticks it ran for.
+ */
+void EdfPolicy::finish(const std::shared_ptr<Process>& process, int core_id, int ticks)
+{
+    (void)core_id;
+    (void)ticks;
+
+    if (process->getDeadline() == 0)
+    {
+        return;
+    }
+
+    {
+        double released = density(*process);
+
+        std::lock_guard<std::mutex> lock(admission_mutex_);
+        density_ = std::max(density_ - released, 0.0);
+        auto it = densities_.find(released);
+        if (it != densities_.end())
+        {
+            densities_.erase(it);
+        }
+    }
+
+    int lateness = config_.cpu_clock->getCpuClock() - (process->getArrivalTick() + process->getDeadline());
+    if (lateness <= 0)
+    {
+        met_++;
+        return;
+    }
+
+    missed_++;
+    int worst = max_lateness_.load();
+    while (lateness > worst && !max_lateness_.compare_exchange_weak(worst, lateness))
+    {
+    }
+}
+
+/**
+ * @brief Get the share of one core a process needs to meet its deadline.
+ * @param process The process.
+ * @return Its demand in ticks, switches included, divided by its deadline.
+ *
+ * Besides its instructions, a process pays for being switched in and for the one preemption
+ * its arrival can cause, each of which may also move a process to another core.
+ */
+double EdfPolicy::density(const Process& process) const
+{
+    double cost = static_cast<double>(process.getLinesOfCode()) * config_.ticks_per_instruction
+                  + 2.0 * (config_.context_switch_ticks + config_.migration_cost_ticks);
+    return cost / process.getDeadline();
+}
+
+/**
+ * @brief Get the summed density the online cores can take under the global EDF bound.
+ * @param largest The largest density among the admitted processes.
+ * @return m - (m - 1) * largest for m online cores.
+ */
+double EdfPolicy::densityBound(double largest) const
+{
+    int cores = queues_.getOnlineCores();
+    return cores - (cores - 1) * largest;
+}
+
+/**
+ * @brief Print the admission and deadline counters.
+ * @param out Output stream to print to.
+ */
+void EdfPolicy::report(std::ostream& out) const
+{
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    double density;
+    double bound;
+    {
+        std::lock_guard<std::mutex> lock(admission_mutex_);
+        density = density_;
+        bound = densityBound(densities_.empty() ? 0.0 : *densities_.rbegin());
+    }
+
+    out << "------------------------------------------" << std::endl;
+    out << "EDF deadlines" << std::endl;
+    out << "Admitted: " << admitted_.load() << "   Rejected (ran best-effort): " << rejected_.load() << std::endl;
+    out << "Met: " << met_.load() << "   Missed: " << missed_.load()
+        << "   Worst lateness: " << max_lateness_.load() << " ticks" << std::endl;
+    out << "Reserved: " << std::fixed << std::setprecision(2) << density << " / " << bound
+        << " (density bound on " << queues_.getOnlineCores() << " cores)" << std::endl;
+
+    out.flags(flags);
+    out.precision(precision);
+}
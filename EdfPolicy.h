@@ -0,0 +1,191 @@
+#ifndef EDF_POLICY_H
+#define EDF_POLICY_H
+
+#include "QueuedPolicy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <set>
+
+/**
+ * @class DeadlineQueue
+ * @brief Ready processes with deadlines in a min-heap on absolute deadline.
+ *
+ * Push and pop are O(log n). Ties go to the process that was queued first.
+ */
+class DeadlineQueue
+{
+public:
+    void push(std::shared_ptr<Process> process)
+    {
+        int due = process->getArrivalTick() + process->getDeadline();
+        heap_.push(Entry{due, sequence_++, std::move(process)});
+    }
+
+    std::shared_ptr<Process> pop()
+    {
+        std::shared_ptr<Process> process = heap_.top().process;
+        heap_.pop();
+        return process;
+    }
+
+    size_t size() const
+    {
+        return heap_.size();
+    }
+
+    /**
+     * @brief Get the earliest absolute deadline in the queue.
+     * @return The tick, or INT_MAX if the queue is empty.
+     */
+    int earliestDeadline() const
+    {
+        return heap_.empty() ? INT_MAX : heap_.top().due;
+    }
+
+private:
+    /**
+     * @struct Entry
+     * @brief A queued process with its key.
+     */
+    struct Entry
+    {
+        int due;                          ///< Absolute deadline tick.
+        unsigned long long sequence;      ///< Queue order, for FIFO ties.
+        std::shared_ptr<Process> process; ///< The process.
+
+        bool operator<(const Entry& other) const
+        {
+            // std::priority_queue is a max-heap, so "less" means "runs later"
+            if (due != other.due)
+            {
+                return due > other.due;
+            }
+            return sequence > other.sequence;
+        }
+    };
+
+    std::priority_queue<Entry> heap_;     ///< The heap.
+    unsigned long long sequence_ = 0;     ///< Next queue order number.
+};
+
+/**
+ * @class EdfPolicy
+ * @brief Global Earliest Deadline First, with best-effort processes running in round robin behind.
+ *
+ * A process created with `screen -s <name> -d <ticks>`, or any process when edf-deadline-ticks is
+ * set, must finish within that many ticks of arrival. Processes with deadlines share one queue
+ * ordered by deadline, and every core takes the earliest deadline from it before looking at its
+ * own queue of best-effort processes; a process with a deadline re-checks every quantum-cycles
+ * instructions whether an earlier one is waiting.
+ *
+ * Since the queue is global, the admission test is the density bound for global EDF on m cores
+ * (Goossens, Funk and Baruah): the summed density (demand / deadline) of the admitted processes
+ * may not exceed m - (m - 1) times the largest density among them. A process's demand is its
+ * instruction cost plus two context switches and two migrations: being switched in, and the one
+ * preemption its arrival can cause. A process that would overload the cores runs as best-effort.
+ */
+class EdfPolicy : public QueuedPolicy<EdfPolicy>
+{
+public:
+    using QueuedPolicy::QueuedPolicy;
+
+    void admit(std::shared_ptr<Process> process) override;
+    void resume(std::shared_ptr<Process> process, int core_id) override;
+    bool hasWork() const override;
+    void report(std::ostream& out) const override;
+
+    /**
+     * @brief Pick the earliest deadline waiting on any core, or else a best-effort process.
+     * @param core_id The core asking for work.
+     * @return The process, or nullptr if nothing is ready.
+     */
+    std::shared_ptr<Process> pickNext(int core_id)
+    {
+        {
+            std::lock_guard<std::mutex> lock(deadline_mutex_);
+            if (deadlines_.size() > 0)
+            {
+                return deadlines_.pop();
+            }
+        }
+        return queues_.pop(core_id);
+    }
+
+    /**
+     * @brief Every process is re-checked after each quantum.
+     * @return The time slice in instructions.
+     */
+    int timeSlice(const Process&, int) const
+    {
+        return std::max(config_.quantum_cycles, 1);
+    }
+
+    /**
+     * @brief Keep running a process with a deadline unless an earlier deadline is waiting.
+     * @param process The running process.
+     * @param core_id The core it runs on.
+     * @return True if the process should keep the core.
+     */
+    bool keepRunning(const Process& process, int core_id)
+    {
+        (void)core_id;
+
+        if (process.getDeadline() == 0)
+        {
+            return false;
+        }
+
+        int due = process.getArrivalTick() + process.getDeadline();
+        std::lock_guard<std::mutex> lock(deadline_mutex_);
+        return due <= deadlines_.earliestDeadline();
+    }
+
+    /**
+     * @brief Queue a preempted process again: by deadline if it has one, on its core otherwise.
+     * @param process The preempted process.
+     * @param core_id The core it ran on.
+     * @param ticks Ticks it ran for.
+     */
+    void requeue(std::shared_ptr<Process> process, int core_id, int ticks);
+
+    /**
+     * @brief Record whether a process met its deadline and release its share of the cores.
+     * @param process The finished process.
+     * @param core_id The core it ran on.
+     * @param ticks Ticks it ran for.
+     */
+    void finish(const std::shared_ptr<Process>& process, int core_id, int ticks);
+
+private:
+    /**
+     * @brief Get the share of one core a process needs to meet its deadline.
+     * @param process The process.
+     * @return Its demand in ticks, switches included, divided by its deadline.
+     */
+    double density(const Process& process) const;
+
+    /**
+     * @brief Get the summed density the online cores can take under the global EDF bound.
+     * @param largest The largest density among the admitted processes.
+     * @return m - (m - 1) * largest for m online cores.
+     */
+    double densityBound(double largest) const;
+
+    mutable std::mutex deadline_mutex_;     ///< Guards deadlines_.
+    DeadlineQueue deadlines_;               ///< Ready processes with deadlines, shared by all cores.
+    mutable std::mutex admission_mutex_;    ///< Guards density_ and densities_.
+    double density_ = 0.0;                  ///< Summed density of unfinished admitted processes.
+    std::multiset<double> densities_;       ///< Density of each unfinished admitted process.
+    std::atomic<long long> admitted_{0};    ///< Processes admitted with a deadline.
+    std::atomic<long long> rejected_{0};    ///< Processes that failed the admission test.
+    std::atomic<long long> met_{0};         ///< Processes that finished by their deadline.
+    std::atomic<long long> missed_{0};      ///< Processes that finished after their deadline.
+    std::atomic<int> max_lateness_{0};      ///< Worst lateness of a missed deadline in ticks.
+};
+
+#endif
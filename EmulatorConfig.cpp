@@ -0,0 +1,167 @@
+#include "EmulatorConfig.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+/**
+ * @brief Read the settings from a config file. Optional keys go one per line; unknown ones are
+ * reported and their line skipped.
+ * @param path The config file.
+ * @return False if the file could not be opened.
+ */
+bool EmulatorConfig::load(const std::string& path)
+{
+    std::ifstream config_file(path);
+    if (!config_file.is_open())
+    {
+        return false;
+    }
+
+    // Temporary variable to skip keys in the file
+    std::string temp;
+
+    config_file >> temp >> num_cpu;
+    config_file >> temp >> std::quoted(scheduler);
+    config_file >> temp >> quantum_cycles;
+    config_file >> temp >> batch_process_freq;
+    config_file >> temp >> min_ins;
+    config_file >> temp >> max_ins;
+    config_file >> temp >> delays_per_exec;
+    config_file >> temp >> max_mem;
+    config_file >> temp >> mem_per_frame;
+    config_file >> temp >> min_mem_per_proc;
+    config_file >> temp >> max_mem_per_proc;
+
+    // Optional keys may follow the required ones in any order
+    while (config_file >> temp)
+    {
+        if (temp == "clock-mode")
+        {
+            config_file >> std::quoted(clock_mode);
+        }
+        else if (temp == "tickless-idle")
+        {
+            config_file >> tickless_idle;
+        }
+        else if (temp == "context-switch-ticks")
+        {
+            config_file >> context_switch_ticks;
+        }
+        else if (temp == "migration-cost-ticks")
+        {
+            config_file >> migration_cost_ticks;
+        }
+        else if (temp == "trace")
+        {
+            config_file >> trace;
+        }
+        else if (temp == "cpu-affinity")
+        {
+            config_file >> std::quoted(cpu_affinity);
+        }
+        else if (temp == "housekeeping-cpus")
+        {
+            config_file >> std::quoted(housekeeping_cpus);
+        }
+        else if (temp == "seed")
+        {
+            config_file >> seed;
+        }
+        else if (temp == "record-run")
+        {
+            config_file >> std::quoted(record_run);
+        }
+        else if (temp == "replay-run")
+        {
+            config_file >> std::quoted(replay_run);
+        }
+        else if (temp == "requeue-affinity")
+        {
+            config_file >> policy_config.requeue_affinity;
+        }
+        else if (temp == "mlfq-levels")
+        {
+            config_file >> policy_config.mlfq_levels;
+        }
+        else if (temp == "mlfq-quanta")
+        {
+            // Quoted, space-separated list, e.g. "2 4 8"
+            std::string quanta;
+            config_file >> std::quoted(quanta);
+
+            std::istringstream quanta_stream(quanta);
+            policy_config.mlfq_quanta.clear();
+            for (int quantum; quanta_stream >> quantum;)
+            {
+                policy_config.mlfq_quanta.push_back(quantum);
+            }
+        }
+        else if (temp == "mlfq-boost-ticks")
+        {
+            config_file >> policy_config.mlfq_boost_ticks;
+        }
+        else if (temp == "edf-deadline-ticks")
+        {
+            config_file >> policy_config.edf_deadline_ticks;
+        }
+        else if (temp == "stride-default-tickets")
+        {
+            config_file >> policy_config.stride_default_tickets;
+        }
+        else if (temp == "stride-tickets")
+        {
+            // Quoted, space-separated prefix=tickets pairs, e.g. "tenant_a=300 tenant_b=100"
+            std::string tickets;
+            config_file >> std::quoted(tickets);
+
+            std::istringstream tickets_stream(tickets);
+            policy_config.stride_tickets.clear();
+            for (std::string pair; tickets_stream >> pair;)
+            {
+                size_t equals = pair.rfind('=');
+                if (equals == std::string::npos || equals == 0)
+                {
+                    std::cerr << "Error: Invalid stride-tickets entry '" << pair << "', expected prefix=tickets." << std::endl;
+                    continue;
+                }
+                policy_config.stride_tickets.emplace_back(pair.substr(0, equals), std::atoi(pair.c_str() + equals + 1));
+            }
+        }
+        else
+        {
+            // The value may be several words, quoted or not; skip to the next key
+            std::cerr << "Unknown config key: " << temp << std::endl;
+            std::getline(config_file, temp);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Describe the settings a recorded run depends on, for RunLog to check on replay.
+ * @return The settings as space-separated key value pairs.
+ */
+std::string EmulatorConfig::describeRun() const
+{
+    std::ostringstream text;
+    text << "num-cpu " << num_cpu << " scheduler " << scheduler << " quantum-cycles " << quantum_cycles
+         << " delay-per-exec " << delays_per_exec << " max-overall-mem " << max_mem << " mem-per-frame " << mem_per_frame
+         << " context-switch-ticks " << context_switch_ticks << " migration-cost-ticks " << migration_cost_ticks
+         << " requeue-affinity " << policy_config.requeue_affinity << " mlfq-levels " << policy_config.mlfq_levels << " mlfq-quanta";
+    for (int quantum : policy_config.mlfq_quanta)
+    {
+        text << " " << quantum;
+    }
+    text << " mlfq-boost-ticks " << policy_config.mlfq_boost_ticks << " stride-default-tickets " << policy_config.stride_default_tickets
+         << " stride-tickets";
+    for (const auto& [prefix, tickets] : policy_config.stride_tickets)
+    {
+        text << " " << prefix << "=" << tickets;
+    }
+    text << " edf-deadline-ticks " << policy_config.edf_deadline_ticks;
+    return text.str();
+}
@@ -0,0 +1,61 @@
+#ifndef EMULATOR_CONFIG_H
+#define EMULATOR_CONFIG_H
+
+#include "SchedulingPolicy.h"
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @struct EmulatorConfig
+ * @brief Settings read from config.txt.
+ *
+ * The first eleven keys are required and must appear in order; the optional keys after them may
+ * appear in any order. Shared by the console and the headless benchmark so both read a config
+ * file the same way.
+ */
+struct EmulatorConfig
+{
+    int num_cpu = 1;                    ///< Number of CPUs
+    std::string scheduler = "fcfs";     ///< Scheduler type used
+    int quantum_cycles = 1;             ///< Quantum cycles for round-robin scheduling
+    int batch_process_freq = 1;         ///< Frequency of batch process generation
+    int min_ins = 1;                    ///< Minimum instructions per process
+    int max_ins = 1;                    ///< Maximum instructions per process
+    int delays_per_exec = 0;            ///< Number of delays per process execution
+    size_t max_mem = 0;                 ///< Maximum overall memory
+    size_t mem_per_frame = 0;           ///< Memory per frame for paging
+    size_t min_mem_per_proc = 0;        ///< Minimum memory per process
+    size_t max_mem_per_proc = 0;        ///< Maximum memory per process
+    std::string clock_mode = "real";    ///< Clock mode ("real" or "virtual")
+    int tickless_idle = 0;              ///< Stop the real-time clock while nothing is runnable
+    int context_switch_ticks = 0;       ///< Ticks charged to a core for each context switch
+    int migration_cost_ticks = 0;       ///< Ticks charged to a core that resumes a process from another core
+    int trace = 1;                      ///< Record scheduler trace events
+    std::string cpu_affinity = "off";   ///< Host CPU placement of the core threads ("off", "auto" or a CPU list)
+    std::string housekeeping_cpus;      ///< Host CPUs of the clock and generator threads, empty to derive them
+    unsigned seed = 0;                  ///< Seed of the generated process sizes, 0 for a different mix every run
+    std::string record_run;             ///< Run log to record every scheduling decision to, empty for none
+    std::string replay_run;             ///< Run log to replay instead of generating processes, empty for none
+    PolicyConfig policy_config;         ///< Policy-specific settings (e.g. MLFQ levels)
+
+    /**
+     * @brief Read the settings from a config file. Optional keys go one per line; unknown ones are
+     * reported and their line skipped.
+     * @param path The config file.
+     * @return False if the file could not be opened.
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief Describe the settings a recorded run depends on, for RunLog to check on replay.
+     *
+     * Process generation settings are left out, since a replay takes its arrivals from the log,
+     * and so are host-side settings such as cpu-affinity.
+     *
+     * @return The settings as space-separated key value pairs.
+     */
+    std::string describeRun() const;
+};
+
+#endif
@@ -0,0 +1,9 @@
+#include "FcfsPolicy.h"
+
+namespace
+{
+    const bool registered = PolicyRegistry::add("fcfs", [](const PolicyConfig& config)
+    {
+        return std::unique_ptr<SchedulingPolicy>(new FcfsPolicy(config));
+    });
+}
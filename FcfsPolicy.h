@@ -0,0 +1,27 @@
+#ifndef FCFS_POLICY_H
+#define FCFS_POLICY_H
+
+#include "QueuedPolicy.h"
+
+#include <climits>
+
+/**
+ * @class FcfsPolicy
+ * @brief First Come First Serve: processes run to completion in arrival order.
+ */
+class FcfsPolicy : public QueuedPolicy<FcfsPolicy>
+{
+public:
+    using QueuedPolicy::QueuedPolicy;
+
+    /**
+     * @brief FCFS never preempts.
+     * @return An unbounded time slice.
+     */
+    int timeSlice(const Process&, int) const
+    {
+        return INT_MAX;
+    }
+};
+
+#endif
@@ -9,6 +9,14 @@
 #include <iomanip>
 #include <memory>
 
+namespace
+{
+    const bool registered = AllocatorRegistry::add("flat", [](size_t maximum_size, size_t mem_per_frame)
+    {
+        return std::unique_ptr<IMemoryAllocator>(new FlatMemoryAllocator(maximum_size, mem_per_frame));
+    });
+}
+
 /**
  * @brief Constructor for FlatMemoryAllocator.
  * @param maximum_size The total size of the memory pool.
@@ -26,7 +34,7 @@ FlatMemoryAllocator::FlatMemoryAllocator(size_t maximum_size, size_t mem_per_fra
  */
 FlatMemoryAllocator::~FlatMemoryAllocator()
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
     memory.clear();
     allocation_map.clear();
 }
@@ -40,7 +48,7 @@ void* FlatMemoryAllocator::allocate(std::shared_ptr<Process> process)
 {
     size_t size = process->getMemoryRequired();
 
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
 
     for (auto it = free_blocks.begin(); it != free_blocks.end(); ++it)
     {
@@ -51,6 +59,9 @@ void* FlatMemoryAllocator::allocate(std::shared_ptr<Process> process)
         {
             allocateAt(block_start, size);
             n_process++;
+            // Stamp under the lock, or eviction can see the previous (older) time and pick it straight away
+            process->setAllocTime();
+            age_list.pushBack(*process);
             process_list[block_start] = process;
             return reinterpret_cast<void*>(&memory[block_start]);
         }
@@ -64,13 +75,22 @@ void* FlatMemoryAllocator::allocate(std::shared_ptr<Process> process)
  */
 void FlatMemoryAllocator::deallocate(std::shared_ptr<Process> process)
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
+    release(process);
+}
 
+/**
+ * @brief Frees the block of a resident process. The caller holds memory_mutex.
+ * @param process The process whose memory is freed.
+ */
+void FlatMemoryAllocator::release(const std::shared_ptr<Process>& process)
+{
     size_t index = static_cast<char*>(process->getMemory()) - &memory[0];
     if (index < maximum_size && process_list.count(index))
     {
         size_t size = process->getMemoryRequired();
         deallocateAt(index, size);
+        age_list.remove(*process);
         process_list.erase(index);
         n_process--;
     }
@@ -81,7 +101,7 @@ void FlatMemoryAllocator::deallocate(std::shared_ptr<Process> process)
  */
 void FlatMemoryAllocator::visualizeMemory()
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
 
     for (char cell : memory)
     {
@@ -95,7 +115,7 @@ void FlatMemoryAllocator::visualizeMemory()
  */
 void FlatMemoryAllocator::initializeMemory()
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
     std::fill(memory.begin(), memory.end(), '.');
     std::fill(allocation_map.begin(), allocation_map.end(), false);
     free_blocks.clear();
@@ -181,7 +201,7 @@ void FlatMemoryAllocator::deallocateAt(size_t index, size_t size)
  */
 int FlatMemoryAllocator::getNProcess()
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
     return n_process;
 }
 
@@ -191,7 +211,7 @@ int FlatMemoryAllocator::getNProcess()
  */
 std::map<size_t, std::shared_ptr<Process>> FlatMemoryAllocator::getProcessList()
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
     return process_list;
 }
 
@@ -201,111 +221,87 @@ std::map<size_t, std::shared_ptr<Process>> FlatMemoryAllocator::getProcessList()
  */
 size_t FlatMemoryAllocator::getMaxMemory()
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
     return maximum_size;
 }
 
 /**
  * @brief Gets the current amount of external fragmentation.
- * @return The size of external fragmentation.
+ * @return The free memory, contiguous or not, as the paging allocator counts it.
  */
 size_t FlatMemoryAllocator::getExternalFragmentation()
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
-    size_t total_free_space = 0;
-    size_t current_free_block_size = 0;
-
-    for (size_t i = 0; i < maximum_size; ++i)
-    {
-        if (!allocation_map[i])
-        {
-            current_free_block_size++;
-        }
-        else
-        {
-            if (current_free_block_size > 0)
-            {
-                total_free_space += current_free_block_size;
-                current_free_block_size = 0;
-            }
-        }
-    }
-
-    if (current_free_block_size > 0)
-    {
-        total_free_space += current_free_block_size;
-    }
-
-    return total_free_space;
+    std::lock_guard<TimedMutex> lock(memory_mutex);
+    return maximum_size - allocated_size;
 }
 
 /**
- * @brief Deallocates the oldest process in memory to free up space.
+ * @brief Deallocates the oldest process in memory that is not running, to free up space.
  * @param mem_size The size of memory to free.
+ * @return True if a process was deallocated, false if every resident process is running.
  */
-void FlatMemoryAllocator::deallocateOldest(size_t mem_size)
+bool FlatMemoryAllocator::deallocateOldest(size_t mem_size)
 {
-    std::chrono::time_point<std::chrono::system_clock> oldest_time = std::chrono::time_point<std::chrono::system_clock>::max();
-    size_t oldest_index = 0;
     std::shared_ptr<Process> oldest_process = nullptr;
-
-    for (const auto& pair : process_list)
+    std::chrono::time_point<std::chrono::system_clock> alloc_time;
+    int command_counter = 0;
     {
-        size_t index = pair.first;
-        std::shared_ptr<Process> process = pair.second;
-
-        std::chrono::time_point<std::chrono::system_clock> alloc_time = process->getAllocTime();
-
-        if (alloc_time < oldest_time)
+        // Pick and free in one hold, so no core can claim the victim in between
+        std::lock_guard<TimedMutex> lock(memory_mutex);
+        Process* victim = age_list.findVictim();
+        if (victim)
         {
-            oldest_time = alloc_time;
-            oldest_index = index;
-            oldest_process = process;
+            oldest_process = process_list[static_cast<char*>(victim->getMemory()) - &memory[0]];
+            // Once the lock is released the victim can be loaded and run again
+            alloc_time = oldest_process->getAllocTime();
+            command_counter = oldest_process->getCommandCounter();
+            release(oldest_process);
+            oldest_process->setMemory(nullptr);
         }
     }
 
-    if (oldest_process)
+    if (!oldest_process)
     {
-        while (oldest_process->getState() == Process::ProcessState::RUNNING)
-        {
-            // Wait until the process is not running
-        }
+        return false;
+    }
+
+    std::ofstream backing_store("backingstore.txt", std::ios::app);
 
-        std::ofstream backing_store("backingstore.txt", std::ios::app);
+    if (backing_store.is_open())
+    {
+        std::time_t alloc_time_t = std::chrono::system_clock::to_time_t(alloc_time);
+        std::tm alloc_time_tm;
 
-        if (backing_store.is_open())
+        if (localtime_s(&alloc_time_tm, &alloc_time_t) == 0)
         {
-            std::time_t alloc_time_t = std::chrono::system_clock::to_time_t(oldest_process->getAllocTime());
-            std::tm alloc_time_tm;
-
-            if (localtime_s(&alloc_time_tm, &alloc_time_t) == 0)
-            {
-                backing_store << "Process ID: " << oldest_process->getPID();
-                backing_store << "  Name: " << oldest_process->getName();
-                backing_store << "  Command Counter: " << oldest_process->getCommandCounter()
-                              << "/" << oldest_process->getLinesOfCode() << "\n";
-                backing_store << "Memory Size: " << oldest_process->getMemoryRequired() << " KB\n";
-                backing_store << "Num Pages: " << oldest_process->getNumPages() << "\n";
-                backing_store << "============================================================================\n";
-
-                backing_store.close();
-            }
-            else
-            {
-                std::cerr << "Failed to convert time to local time format." << std::endl;
-            }
+            backing_store << "Process ID: " << oldest_process->getPID();
+            backing_store << "  Name: " << oldest_process->getName();
+            backing_store << "  Command Counter: " << command_counter
+                          << "/" << oldest_process->getLinesOfCode() << "\n";
+            backing_store << "Memory Size: " << oldest_process->getMemoryRequired() << " KB\n";
+            backing_store << "Num Pages: " << oldest_process->getNumPages() << "\n";
+            backing_store << "============================================================================\n";
+
+            backing_store.close();
         }
-
-        if (oldest_process->getState() != Process::ProcessState::FINISHED)
+        else
         {
-            deallocate(oldest_process);
-            oldest_process->setMemory(nullptr);
+            std::cerr << "Failed to convert time to local time format." << std::endl;
         }
     }
-    else
-    {
-        std::cerr << "No process found to deallocate.\n";
-    }
+    return true;
+}
+
+/**
+ * @brief Marks a process running if it is resident, under the memory lock.
+ * @param process The process a core is about to run.
+ * @return True if the process is resident.
+ */
+bool FlatMemoryAllocator::claim(Process& process)
+{
+    std::lock_guard<TimedMutex> lock(memory_mutex);
+    process.setState(Process::ProcessState::RUNNING);
+    return process.getMemory() != nullptr;
 }
 
 /**
@@ -325,3 +321,12 @@ size_t FlatMemoryAllocator::getPageOut()
 {
     return 0;
 }
+
+/**
+ * @brief Gets how often the memory lock was taken and how long it was held.
+ * @return The lock counters.
+ */
+LockStats FlatMemoryAllocator::getLockStats()
+{
+    return memory_mutex.getStats();
+}
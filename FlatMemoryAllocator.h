@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <iostream>
+#include "AgeList.h"
 #include "IMemoryAllocator.h"
 #include <mutex>
 #include <map>
@@ -69,10 +70,18 @@ public:
     size_t getExternalFragmentation() override;
 
     /**
-     * @brief Deallocate the oldest process in memory to make space.
+     * @brief Deallocate the oldest process in memory that is not running, to make space.
      * @param mem_size The size of memory required to be deallocated.
+     * @return True if a process was deallocated.
      */
-    void deallocateOldest(size_t mem_size) override;
+    bool deallocateOldest(size_t mem_size) override;
+
+    /**
+     * @brief Mark a process running if it is resident, under the memory lock.
+     * @param process The process a core is about to run.
+     * @return True if the process is resident.
+     */
+    bool claim(Process& process) override;
 
     /**
      * @brief Get the number of page-ins that occurred.
@@ -86,6 +95,12 @@ public:
      */
     size_t getPageOut() override;
 
+    /**
+     * @brief Get how often the memory lock was taken and how long it was held.
+     * @return The lock counters.
+     */
+    LockStats getLockStats() override;
+
 private:
     size_t maximum_size;                        ///< Total size of the memory pool.
     size_t mem_per_frame;                       ///< Size of each memory frame.
@@ -94,9 +109,10 @@ private:
     std::vector<bool> allocation_map;           ///< Allocation tracking map.
     int n_process;                              ///< Number of processes in memory.
 
-    std::mutex memory_mutex;                    ///< Mutex for thread-safe memory access.
+    TimedMutex memory_mutex;                    ///< Mutex for thread-safe memory access.
     std::map<size_t, std::shared_ptr<Process>> process_list; ///< Map of starting memory indices to processes.
     std::map<size_t, size_t> free_blocks;       ///< Map of free memory blocks.
+    AgeList age_list;                           ///< Resident processes, oldest first, for eviction.
 
     /**
      * @brief Initializes memory and allocation map.
@@ -124,6 +140,12 @@ private:
      * @param size The size of the block to deallocate.
      */
     void deallocateAt(size_t index, size_t size);
+
+    /**
+     * @brief Frees the block of a resident process. The caller holds memory_mutex.
+     * @param process The process whose memory is freed.
+     */
+    void release(const std::shared_ptr<Process>& process);
 };
 
 #endif
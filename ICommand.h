@@ -3,6 +3,17 @@
 
 #include <string>
 
+/**
+ * @struct CommandBatch
+ * @brief State shared by the commands of one batch, so their I/O can be done once per batch.
+ */
+struct CommandBatch
+{
+    int core = -1;          ///< Core running the batch.
+    std::string timestamp;  ///< Timestamp of the batch, filled in by the first command that needs it.
+    std::string output;     ///< Lines for the process log, written when the batch ends.
+};
+
 /**
  * @class ICommand
  * @brief Abstract base class for all command types that can be executed.
@@ -45,6 +56,17 @@ public:
      */
     virtual void setCore(int core) = 0;
 
+    /**
+     * @brief Execute the command as part of a batch.
+     * Commands with output should append it to batch.output instead of writing it themselves.
+     * @param batch The batch the command belongs to.
+     */
+    virtual void executeBatched(CommandBatch& batch)
+    {
+        setCore(batch.core);
+        execute();
+    }
+
 protected:
     int pid_;                ///< Process ID associated with the command.
     CommandType command_type_; ///< The type of the command.
@@ -0,0 +1,54 @@
+#include "IMemoryAllocator.h"
+
+/**
+ * @brief Register an allocator under a name.
+ * @param name The name.
+ * @param factory Creates the allocator from the total memory and the frame size.
+ * @return True, so registration can initialise a static.
+ */
+bool AllocatorRegistry::add(const std::string& name, Factory factory)
+{
+    factories()[name] = std::move(factory);
+    return true;
+}
+
+/**
+ * @brief Create an allocator by name.
+ * @param name The registered name.
+ * @param maximum_size Total memory in KB.
+ * @param mem_per_frame Frame size in KB.
+ * @return The allocator, or nullptr if no allocator has that name.
+ */
+std::unique_ptr<IMemoryAllocator> AllocatorRegistry::create(const std::string& name, size_t maximum_size, size_t mem_per_frame)
+{
+    auto it = factories().find(name);
+    if (it == factories().end())
+    {
+        return nullptr;
+    }
+    return it->second(maximum_size, mem_per_frame);
+}
+
+/**
+ * @brief Get the registered names in alphabetical order.
+ * @return The allocator names.
+ */
+std::vector<std::string> AllocatorRegistry::names()
+{
+    std::vector<std::string> result;
+    for (const auto& entry : factories())
+    {
+        result.push_back(entry.first);
+    }
+    return result;
+}
+
+/**
+ * @brief Get the factory table. Built on first use so allocators can register from static initialisers.
+ * @return The table of factories by name.
+ */
+std::map<std::string, AllocatorRegistry::Factory>& AllocatorRegistry::factories()
+{
+    static std::map<std::string, Factory> table;
+    return table;
+}
@@ -6,7 +6,11 @@
 #include <iostream>
 #include <map>
 #include <tuple>
+#include <memory>
+#include <string>
+#include <functional>
 #include "Process.h"
+#include "TimedMutex.h"
 
 /**
  * @class IMemoryAllocator
@@ -18,6 +22,8 @@
 class IMemoryAllocator
 {
 public:
+    virtual ~IMemoryAllocator() = default;
+
     /**
      * @brief Allocate memory for a process.
      * @param process Shared pointer to the process requesting memory allocation.
@@ -63,12 +69,27 @@ public:
     virtual size_t getExternalFragmentation() = 0;
 
     /**
-     * @brief Deallocate the oldest process in memory.
+     * @brief Deallocate the oldest process in memory that is not running.
      * @param mem_size The size of memory to free.
+     * @return True if a process was deallocated, false if every resident process is running.
+     *
+     * This method deallocates the oldest process to make space for new memory requests. The
+     * victim is chosen, unlinked and freed in one hold of the allocator's lock, and its memory
+     * pointer is cleared before the lock is released.
+     */
+    virtual bool deallocateOldest(size_t mem_size) = 0;
+
+    /**
+     * @brief Mark a process running under the allocator's lock, so eviction cannot pick it
+     * from then on.
+     * @param process The process a core is about to run.
+     * @return True if the process is resident.
      *
-     * This method deallocates the oldest process to make space for new memory requests.
+     * Checking residency and marking the process running in one hold of the lock means an
+     * eviction either finishes before the check, which then sees no memory, or runs after it
+     * and skips the process.
      */
-    virtual void deallocateOldest(size_t mem_size) = 0;
+    virtual bool claim(Process& process) = 0;
 
     /**
      * @brief Get the number of page-ins that have occurred.
@@ -81,6 +102,52 @@ public:
      * @return The number of page-outs.
      */
     virtual size_t getPageOut() = 0;
+
+    /**
+     * @brief Get how often the allocator's lock was taken and how long it was held.
+     * @return The counters; all zero for an allocator that does not time its lock.
+     */
+    virtual LockStats getLockStats()
+    {
+        return LockStats();
+    }
+};
+
+/**
+ * @class AllocatorRegistry
+ * @brief Maps allocator names to factories, so tools such as the allocator benchmark pick up
+ * every allocator without being changed.
+ */
+class AllocatorRegistry
+{
+public:
+    using Factory = std::function<std::unique_ptr<IMemoryAllocator>(size_t maximum_size, size_t mem_per_frame)>;
+
+    /**
+     * @brief Register an allocator under a name.
+     * @param name The name.
+     * @param factory Creates the allocator from the total memory and the frame size.
+     * @return True, so registration can initialise a static.
+     */
+    static bool add(const std::string& name, Factory factory);
+
+    /**
+     * @brief Create an allocator by name.
+     * @param name The registered name.
+     * @param maximum_size Total memory in KB.
+     * @param mem_per_frame Frame size in KB.
+     * @return The allocator, or nullptr if no allocator has that name.
+     */
+    static std::unique_ptr<IMemoryAllocator> create(const std::string& name, size_t maximum_size, size_t mem_per_frame);
+
+    /**
+     * @brief Get the registered names in alphabetical order.
+     * @return The allocator names.
+     */
+    static std::vector<std::string> names();
+
+private:
+    static std::map<std::string, Factory>& factories();
 };
 
 #endif
@@ -0,0 +1,204 @@
+#include "MlfqPolicy.h"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace
+{
+    const bool registered = PolicyRegistry::add("mlfq", [](const PolicyConfig& config)
+    {
+        return std::unique_ptr<SchedulingPolicy>(new MlfqPolicy(config));
+    });
+}
+
+/**
+ * @brief Constructor for MlfqPolicy.
+ * @param config The policy settings.
+ *
+ * Levels without an explicit quantum get double the quantum of the level above, starting from
+ * quantum-cycles.
+ */
+MlfqPolicy::MlfqPolicy(const PolicyConfig& config)
+    : QueuedPolicy(config),
+      levels_(std::clamp(config.mlfq_levels, 1, LevelQueue::MAX_LEVELS)),
+      boost_ticks_(std::max(config.mlfq_boost_ticks, 0)),
+      next_boost_(boost_ticks_),
+      stats_(new LevelStats[LevelQueue::MAX_LEVELS])
+{
+    int quantum = std::max(config.quantum_cycles, 1);
+    for (int level = 0; level < levels_; ++level)
+    {
+        if (level < static_cast<int>(config.mlfq_quanta.size()))
+        {
+            quantum = std::max(config.mlfq_quanta[level], 1);
+        }
+        else if (level > 0)
+        {
+            quantum *= 2;
+        }
+        quanta_.push_back(quantum);
+    }
+}
+
+/**
+ * @brief Accept a new process at its priority level, 0 unless a workload trace gave one.
+ * @param process The new process.
+ */
+void MlfqPolicy::admit(std::shared_ptr<Process> process)
+{
+    int level = std::clamp(process->getPriorityLevel(), 0, levels_ - 1);
+    process->setPriorityLevel(level);
+    stats_[level].depth++;
+    queues_.admit(std::move(process));
+}
+
+/**
+ * @brief Put back a process that could not run, at the level it was picked from.
+ * @param process The process.
+ * @param core_id The core whose queue should take it.
+ */
+void MlfqPolicy::resume(std::shared_ptr<Process> process, int core_id)
+{
+    stats_[process->getPriorityLevel()].depth++;
+    queues_.push(std::move(process), core_id);
+}
+
+/**
+ * @brief Pick the next process for a core, boosting first if a boost is due.
+ * @param core_id The core asking for work.
+ * @return The process, or nullptr if nothing is ready.
+ */
+std::shared_ptr<Process> MlfqPolicy::pickNext(int core_id)
+{
+    int now = config_.cpu_clock->getCpuClock();
+
+    queues_.mergeAdmission(core_id);
+    boostIfDue(now);
+
+    std::shared_ptr<Process> process = stealHigherLevel(core_id);
+    if (!process)
+    {
+        process = queues_.pop(core_id);
+    }
+    if (process)
+    {
+        LevelStats& stats = stats_[process->getPriorityLevel()];
+        stats.depth--;
+        stats.dispatches++;
+        stats.wait_ticks += std::max(now - process->getReadySince(), 0);
+    }
+    return process;
+}
+
+/**
+ * @brief Take a process from another core if it waits at a higher level than any on this core.
+ * @param core_id The core asking for work.
+ * @return The process, or nullptr if this core's own queue is as good as any.
+ *
+ * The level depths cover every core and the admission ring, so reading them usually shows there
+ * is nothing to look for; other cores' queues are only locked when this core's best level is
+ * lower than the highest occupied one.
+ */
+std::shared_ptr<Process> MlfqPolicy::stealHigherLevel(int core_id)
+{
+    int highest = 0;
+    while (highest < levels_ && stats_[highest].depth.load() <= 0)
+    {
+        highest++;
+    }
+    if (highest == levels_)
+    {
+        return nullptr;
+    }
+
+    auto top = [](const LevelQueue& queue)
+    {
+        return queue.topLevel();
+    };
+    int own = queues_.inspect(core_id, top);
+    if (own <= highest)
+    {
+        return nullptr;
+    }
+    return queues_.popBest(core_id, top, own);
+}
+
+/**
+ * @brief Demote a process that used up its quantum and queue it again.
+ * @param process The preempted process.
+ * @param core_id The core it ran on.
+ * @param ticks Ticks it was charged for.
+ *
+ * A process cut short before its quantum ran out, such as by its core going offline, keeps its
+ * level.
+ */
+void MlfqPolicy::requeue(std::shared_ptr<Process> process, int core_id, int ticks)
+{
+    int level = process->getPriorityLevel();
+    if (ticks >= quanta_[level] * config_.ticks_per_instruction)
+    {
+        level = std::min(level + 1, levels_ - 1);
+        process->setPriorityLevel(level);
+    }
+    stats_[level].depth++;
+    queues_.requeue(std::move(process), core_id);
+}
+
+/**
+ * @brief Move every queued process back to level 0 if the boost period has passed.
+ * @param now The current tick.
+ *
+ * Only the core that wins the race for this period does the boost.
+ */
+void MlfqPolicy::boostIfDue(int now)
+{
+    if (boost_ticks_ == 0)
+    {
+        return;
+    }
+
+    int due = next_boost_.load();
+    if (now < due || !next_boost_.compare_exchange_strong(due, now + boost_ticks_))
+    {
+        return;
+    }
+
+    // The boost has to reach processes still in the admission ring as well
+    queues_.spreadAdmission();
+    queues_.forEachQueue([this](LevelQueue& queue)
+    {
+        queue.boost([this](int level)
+        {
+            stats_[level].depth--;
+            stats_[0].depth++;
+        });
+    });
+    boosts_++;
+}
+
+/**
+ * @brief Print the depth, quantum and average wait of each level.
+ * @param out Output stream to print to.
+ */
+void MlfqPolicy::report(std::ostream& out) const
+{
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << "------------------------------------------" << std::endl;
+    out << "MLFQ levels (boost every " << boost_ticks_ << " ticks, " << boosts_.load() << " boosts)" << std::endl;
+    out << "Level  Quantum   Queued   Avg wait" << std::endl;
+
+    for (int level = 0; level < levels_; ++level)
+    {
+        const LevelStats& stats = stats_[level];
+        long long dispatches = stats.dispatches.load();
+        double average_wait = dispatches > 0 ? static_cast<double>(stats.wait_ticks.load()) / dispatches : 0.0;
+
+        out << std::setw(5) << level << std::setw(9) << quanta_[level] << std::setw(9) << std::max(stats.depth.load(), 0)
+            << std::setw(11) << std::fixed << std::setprecision(1) << average_wait << std::endl;
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,171 @@
+#ifndef MLFQ_POLICY_H
+#define MLFQ_POLICY_H
+
+#include "QueuedPolicy.h"
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+/**
+ * @class LevelQueue
+ * @brief Ready processes split by priority level; pops from the highest non-empty level.
+ */
+class LevelQueue
+{
+public:
+    static constexpr int MAX_LEVELS = 8; ///< Upper bound on mlfq-levels.
+
+    void push(std::shared_ptr<Process> process)
+    {
+        levels_[process->getPriorityLevel()].push_back(std::move(process));
+        size_++;
+    }
+
+    std::shared_ptr<Process> pop()
+    {
+        for (auto& level : levels_)
+        {
+            if (!level.empty())
+            {
+                std::shared_ptr<Process> process = std::move(level.front());
+                level.pop_front();
+                size_--;
+                return process;
+            }
+        }
+        return nullptr;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Get the highest-priority level holding a process.
+     * @return The level, or MAX_LEVELS if the queue is empty.
+     */
+    int topLevel() const
+    {
+        for (int level = 0; level < MAX_LEVELS; ++level)
+        {
+            if (!levels_[level].empty())
+            {
+                return level;
+            }
+        }
+        return MAX_LEVELS;
+    }
+
+    /**
+     * @brief Move every process to level 0, keeping their order within each level.
+     * @param moved Called with the old level of each moved process.
+     */
+    template <typename Moved>
+    void boost(Moved moved)
+    {
+        for (int level = 1; level < MAX_LEVELS; ++level)
+        {
+            for (auto& process : levels_[level])
+            {
+                process->setPriorityLevel(0);
+                moved(level);
+                levels_[0].push_back(std::move(process));
+            }
+            levels_[level].clear();
+        }
+    }
+
+private:
+    std::array<std::deque<std::shared_ptr<Process>>, MAX_LEVELS> levels_; ///< FIFO of each level.
+    size_t size_ = 0;                                                     ///< Processes over all levels.
+};
+
+/**
+ * @class MlfqPolicy
+ * @brief Multi-level feedback queue.
+ *
+ * New processes start at level 0, or at the priority a workload trace gives them. A process
+ * that uses up its level's quantum is demoted one level, and each level down gets a longer
+ * quantum, so short interactive processes finish ahead of long batch jobs. A process preempted
+ * before its quantum runs out keeps its level. Every mlfq-boost-ticks all queued processes go
+ * back to level 0 so batch jobs cannot starve.
+ *
+ * Each core serves its own queue, but never a lower level than is waiting on another core: a
+ * core whose best process is below the highest occupied level takes a process at that level
+ * from the other core first.
+ */
+class MlfqPolicy : public QueuedPolicy<MlfqPolicy, LevelQueue>
+{
+public:
+    /**
+     * @brief Constructor for MlfqPolicy.
+     * @param config The policy settings.
+     */
+    explicit MlfqPolicy(const PolicyConfig& config);
+
+    void admit(std::shared_ptr<Process> process) override;
+    void resume(std::shared_ptr<Process> process, int core_id) override;
+    void report(std::ostream& out) const override;
+
+    /**
+     * @brief Pick the next process for a core, boosting first if a boost is due.
+     * @param core_id The core asking for work.
+     * @return The process, or nullptr if nothing is ready.
+     */
+    std::shared_ptr<Process> pickNext(int core_id);
+
+    /**
+     * @brief A process's quantum depends on its level.
+     * @return The time slice in instructions.
+     */
+    int timeSlice(const Process& process, int) const
+    {
+        return quanta_[process.getPriorityLevel()];
+    }
+
+    /**
+     * @brief Demote a process that used up its quantum and queue it again.
+     * @param process The preempted process.
+     * @param core_id The core it ran on.
+     * @param ticks Ticks it was charged for; fewer than the quantum leave the level as it is.
+     */
+    void requeue(std::shared_ptr<Process> process, int core_id, int ticks);
+
+private:
+    /**
+     * @struct LevelStats
+     * @brief Queue depth and wait totals of one level, across all cores.
+     */
+    struct alignas(64) LevelStats
+    {
+        std::atomic<int> depth{0};            ///< Processes queued at this level.
+        std::atomic<long long> dispatches{0}; ///< Processes picked from this level.
+        std::atomic<long long> wait_ticks{0}; ///< Ticks those processes spent queued.
+    };
+
+    /**
+     * @brief Move every queued process back to level 0 if the boost period has passed.
+     * @param now The current tick.
+     */
+    void boostIfDue(int now);
+
+    /**
+     * @brief Take a process from another core if it waits at a higher level than any on this core.
+     * @param core_id The core asking for work.
+     * @return The process, or nullptr if this core's own queue is as good as any.
+     */
+    std::shared_ptr<Process> stealHigherLevel(int core_id);
+
+    int levels_;                            ///< Number of levels in use.
+    std::vector<int> quanta_;               ///< Quantum of each level in instructions.
+    int boost_ticks_;                       ///< Ticks between boosts, 0 if disabled.
+    std::atomic<int> next_boost_;           ///< Tick of the next boost.
+    std::atomic<long long> boosts_{0};      ///< Boosts done so far.
+    std::unique_ptr<LevelStats[]> stats_;   ///< Statistics of each level.
+};
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * @class MpmcQueue
+ * @brief Bounded lock-free multi-producer/multi-consumer FIFO ring.
+ *
+ * Each cell carries a sequence number that tells producers and consumers whose turn it is, so a
+ * push or pop is one CAS on the shared position plus one release store on the cell. Neither
+ * operation ever blocks; callers decide what to do when the ring is full or empty.
+ *
+ * @tparam T Element type. Must be default-constructible and move-assignable.
+ */
+template <typename T>
+class MpmcQueue
+{
+public:
+    /**
+     * @brief Constructor for MpmcQueue.
+     * @param capacity Number of cells, rounded up to a power of two.
+     */
+    explicit MpmcQueue(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        mask_ = size - 1;
+        cells_.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i)
+        {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /**
+     * @brief Push an element if there is room.
+     * @param value The element to push. Left untouched if the ring is full.
+     * @return True if the element was pushed.
+     */
+    bool tryPush(T& value)
+    {
+        size_t position = enqueue_pos_.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Cell& cell = cells_[position & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - position);
+
+            if (diff == 0)
+            {
+                if (enqueue_pos_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                // The consumer of this cell from the previous lap has not finished yet
+                return false;
+            }
+            else
+            {
+                position = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Pop the oldest element if there is one.
+     * @param value Receives the element.
+     * @return True if an element was popped.
+     */
+    bool tryPop(T& value)
+    {
+        size_t position = dequeue_pos_.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Cell& cell = cells_[position & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+
+            if (diff == 0)
+            {
+                if (dequeue_pos_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    value = std::move(cell.value);
+                    cell.value = T();
+                    cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Get the approximate number of elements.
+     * @return Pushes claimed minus pops claimed; exact when no operation is in flight.
+     */
+    size_t sizeApprox() const
+    {
+        size_t tail = dequeue_pos_.load();
+        size_t head = enqueue_pos_.load();
+        return head > tail ? head - tail : 0;
+    }
+
+    /**
+     * @brief Get the number of cells.
+     * @return The capacity of the ring.
+     */
+    size_t capacity() const
+    {
+        return mask_ + 1;
+    }
+
+private:
+    /**
+     * @struct Cell
+     * @brief One slot of the ring, padded so neighbouring cells never share a cache line.
+     */
+    struct alignas(64) Cell
+    {
+        std::atomic<size_t> sequence{0}; ///< Whose turn it is: position for producers, position + 1 for consumers.
+        T value{};                       ///< The stored element.
+    };
+
+    std::unique_ptr<Cell[]> cells_;                  ///< The ring.
+    size_t mask_ = 0;                                ///< Capacity minus one.
+    alignas(64) std::atomic<size_t> enqueue_pos_{0}; ///< Next position to push to.
+    alignas(64) std::atomic<size_t> dequeue_pos_{0}; ///< Next position to pop from.
+};
+
+#endif
@@ -10,6 +10,14 @@
 #include <memory>
 #include <algorithm>
 
+namespace
+{
+    const bool registered = AllocatorRegistry::add("paging", [](size_t maximum_size, size_t mem_per_frame)
+    {
+        return std::unique_ptr<IMemoryAllocator>(new PagingAllocator(maximum_size, mem_per_frame));
+    });
+}
+
 /**
  * @brief Constructor for PagingAllocator.
  * @param maximum_size The total size of the memory pool.
@@ -36,7 +44,7 @@ PagingAllocator::PagingAllocator(size_t maximum_size, size_t mem_per_frame)
  */
 void* PagingAllocator::allocate(std::shared_ptr<Process> process)
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
     size_t num_frames_needed = process->getNumPages();
     if (num_frames_needed > free_frame_list.size())
     {
@@ -44,9 +52,13 @@ void* PagingAllocator::allocate(std::shared_ptr<Process> process)
     }
 
     size_t frame_index = allocateFrames(num_frames_needed, process);
+    // Stamp under the lock, or eviction can see the previous (older) time and pick it straight away
+    process->setAllocTime();
+    age_list.pushBack(*process);
     process_list[process->getPID()] = process;
     n_process++;
-    return reinterpret_cast<void*>(frame_index);
+    // Offset by one so frame 0 is not mistaken for a failed allocation
+    return reinterpret_cast<void*>(frame_index + 1);
 }
 
 /**
@@ -55,8 +67,22 @@ void* PagingAllocator::allocate(std::shared_ptr<Process> process)
  */
 void PagingAllocator::deallocate(std::shared_ptr<Process> process)
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
-    process_list.erase(process->getPID());
+    std::lock_guard<TimedMutex> lock(memory_mutex);
+    release(process);
+}
+
+/**
+ * @brief Frees the frames of a process. The caller holds memory_mutex.
+ * @param process The process whose frames are freed.
+ */
+void PagingAllocator::release(const std::shared_ptr<Process>& process)
+{
+    if (process_list.erase(process->getPID()) == 0)
+    {
+        // Already evicted by another core
+        return;
+    }
+    age_list.remove(*process);
     n_process--;
 
     auto it = std::find_if(frame_map.begin(), frame_map.end(),
@@ -121,7 +147,7 @@ void PagingAllocator::visualizeMemory()
  */
 int PagingAllocator::getNProcess()
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
     return n_process;
 }
 
@@ -131,7 +157,7 @@ int PagingAllocator::getNProcess()
  */
 std::map<size_t, std::shared_ptr<Process>> PagingAllocator::getProcessList()
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
     return process_list;
 }
 
@@ -141,7 +167,7 @@ std::map<size_t, std::shared_ptr<Process>> PagingAllocator::getProcessList()
  */
 size_t PagingAllocator::getMaxMemory()
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
     return maximum_size;
 }
 
@@ -151,72 +177,77 @@ size_t PagingAllocator::getMaxMemory()
  */
 size_t PagingAllocator::getExternalFragmentation()
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
     return free_frame_list.size() * mem_per_frame;
 }
 
 /**
- * @brief Deallocate the oldest process in memory.
+ * @brief Deallocate the oldest process in memory that is not running.
  * @param mem_size The size of memory to free.
+ * @return True if a process was deallocated, false if every resident process is running.
  */
-void PagingAllocator::deallocateOldest(size_t mem_size)
+bool PagingAllocator::deallocateOldest(size_t mem_size)
 {
-    std::chrono::time_point<std::chrono::system_clock> oldest_time = std::chrono::time_point<std::chrono::system_clock>::max();
-    size_t oldest_index = 0;
     std::shared_ptr<Process> oldest_process = nullptr;
-
-    for (const auto& pair : process_list)
+    std::chrono::time_point<std::chrono::system_clock> alloc_time;
+    int command_counter = 0;
     {
-        size_t index = pair.first;
-        std::shared_ptr<Process> process = pair.second;
-
-        auto alloc_time = process->getAllocTime();
-        if (alloc_time < oldest_time)
+        // Pick and free in one hold, so no core can claim the victim in between
+        std::lock_guard<TimedMutex> lock(memory_mutex);
+        Process* victim = age_list.findVictim();
+        if (victim)
         {
-            oldest_time = alloc_time;
-            oldest_index = index;
-            oldest_process = process;
+            oldest_process = process_list[victim->getPID()];
+            // Once the lock is released the victim can be loaded and run again
+            alloc_time = oldest_process->getAllocTime();
+            command_counter = oldest_process->getCommandCounter();
+            release(oldest_process);
+            oldest_process->setMemory(nullptr);
         }
     }
 
-    if (oldest_process)
+    if (!oldest_process)
     {
-        while (oldest_process->getState() == Process::ProcessState::RUNNING)
-        {
-            // Wait until the process is no longer running.
-        }
+        return false;
+    }
 
-        std::ofstream backing_store("backingstore.txt", std::ios::app);
+    std::ofstream backing_store("backingstore.txt", std::ios::app);
 
-        if (backing_store.is_open())
-        {
-            std::time_t alloc_time_t = std::chrono::system_clock::to_time_t(oldest_process->getAllocTime());
-            std::tm alloc_time_tm;
+    if (backing_store.is_open())
+    {
+        std::time_t alloc_time_t = std::chrono::system_clock::to_time_t(alloc_time);
+        std::tm alloc_time_tm;
 
-            if (localtime_s(&alloc_time_tm, &alloc_time_t) == 0)
-            {
-                backing_store << "Process ID: " << oldest_process->getPID();
-                backing_store << "  Name: " << oldest_process->getName();
-                backing_store << "  Command Counter: " << oldest_process->getCommandCounter()
-                              << "/" << oldest_process->getLinesOfCode() << "\n";
-                backing_store << "Memory Size: " << oldest_process->getMemoryRequired() << " KB\n";
-                backing_store << "Num Pages: " << oldest_process->getNumPages() << "\n";
-                backing_store << "============================================================================\n";
+        if (localtime_s(&alloc_time_tm, &alloc_time_t) == 0)
+        {
+            backing_store << "Process ID: " << oldest_process->getPID();
+            backing_store << "  Name: " << oldest_process->getName();
+            backing_store << "  Command Counter: " << command_counter
+                          << "/" << oldest_process->getLinesOfCode() << "\n";
+            backing_store << "Memory Size: " << oldest_process->getMemoryRequired() << " KB\n";
+            backing_store << "Num Pages: " << oldest_process->getNumPages() << "\n";
+            backing_store << "============================================================================\n";
 
-                backing_store.close();
-            }
-            else
-            {
-                std::cerr << "Failed to convert time to local time format." << std::endl;
-            }
+            backing_store.close();
         }
-
-        if (oldest_process->getState() != Process::ProcessState::FINISHED)
+        else
         {
-            deallocate(oldest_process);
-            oldest_process->setMemory(nullptr);
+            std::cerr << "Failed to convert time to local time format." << std::endl;
         }
     }
+    return true;
+}
+
+/**
+ * @brief Marks a process running if it is resident, under the memory lock.
+ * @param process The process a core is about to run.
+ * @return True if the process is resident.
+ */
+bool PagingAllocator::claim(Process& process)
+{
+    std::lock_guard<TimedMutex> lock(memory_mutex);
+    process.setState(Process::ProcessState::RUNNING);
+    return process.getMemory() != nullptr;
 }
 
 /**
@@ -227,11 +258,12 @@ void PagingAllocator::deallocateOldest(size_t mem_size)
  */
 size_t PagingAllocator::allocateFrames(size_t num_frames, std::shared_ptr<Process> process)
 {
+    // Free frames are not contiguous; take the ones the list holds
     size_t frame_index = free_frame_list.back();
     for (size_t i = 0; i < num_frames; ++i)
     {
+        frame_map[free_frame_list.back()] = process;
         free_frame_list.pop_back();
-        frame_map[frame_index + i] = process;
         n_paged_in++;
     }
     return frame_index;
@@ -262,7 +294,7 @@ void PagingAllocator::deallocateFrames(size_t num_frames, size_t frame_index)
  */
 size_t PagingAllocator::getPageIn()
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
     return n_paged_in;
 }
 
@@ -272,6 +304,15 @@ size_t PagingAllocator::getPageIn()
  */
 size_t PagingAllocator::getPageOut()
 {
-    std::lock_guard<std::mutex> lock(memory_mutex);
+    std::lock_guard<TimedMutex> lock(memory_mutex);
     return n_paged_out;
 }
+
+/**
+ * @brief Get how often the memory lock was taken and how long it was held.
+ * @return The lock counters.
+ */
+LockStats PagingAllocator::getLockStats()
+{
+    return memory_mutex.getStats();
+}
@@ -1,6 +1,7 @@
 #ifndef PAGING_ALLOCATOR_H
 #define PAGING_ALLOCATOR_H
 
+#include "AgeList.h"
 #include "IMemoryAllocator.h"
 #include <vector>
 #include <iostream>
@@ -30,9 +31,11 @@ public:
     std::map<size_t, std::shared_ptr<Process>> getProcessList() override;
     size_t getMaxMemory() override;
     size_t getExternalFragmentation() override;
-    void deallocateOldest(size_t mem_size) override;
+    bool deallocateOldest(size_t mem_size) override;
+    bool claim(Process& process) override;
     size_t getPageIn() override;
     size_t getPageOut() override;
+    LockStats getLockStats() override;
 
 private:
     size_t maximum_size;          ///< Total size of the memory pool.
@@ -46,8 +49,9 @@ private:
     size_t allocated_size;        ///< Currently allocated memory size.
     int n_process;                ///< Number of processes.
 
-    std::mutex memory_mutex;      ///< Mutex for thread-safe memory operations.
+    TimedMutex memory_mutex;      ///< Mutex for thread-safe memory operations.
     std::map<size_t, std::shared_ptr<Process>> process_list; ///< Map of process list with starting memory index.
+    AgeList age_list;             ///< Resident processes, oldest first, for eviction.
 
     /**
      * @brief Allocate a specified number of frames to a process.
@@ -63,6 +67,12 @@ private:
      * @param frame_index Starting frame index.
      */
     void deallocateFrames(size_t num_frames, size_t frame_index);
+
+    /**
+     * @brief Frees the frames of a process. The caller holds memory_mutex.
+     * @param process The process whose frames are freed.
+     */
+    void release(const std::shared_ptr<Process>& process);
 };
 
 #endif
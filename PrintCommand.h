@@ -44,6 +44,26 @@ public:
         outfile.close();
     }
 
+    /**
+     * @brief Execute the print command as part of a batch.
+     * @param batch The batch; the line is appended to its output with the batch's timestamp.
+     */
+    void executeBatched(CommandBatch& batch) override
+    {
+        core_ = batch.core;
+        if (batch.timestamp.empty())
+        {
+            batch.timestamp = getCurrentTimestamp();
+        }
+
+        batch.output += batch.timestamp;
+        batch.output += " Core:";
+        batch.output += std::to_string(core_);
+        batch.output += " \"";
+        batch.output += to_print_;
+        batch.output += "\"\n";
+    }
+
     /**
      * @brief Set the core ID for the command.
      * @param core The core ID to be set.
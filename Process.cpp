@@ -1,5 +1,8 @@
 #include "Process.h"
 
+#include <algorithm>
+#include <fstream>
+
 /**
  * @brief Constructor for Process.
  * @param pid The process ID.
@@ -30,6 +33,32 @@ void Process::executeCurrentCommand()
     }
 }
 
+/**
+ * @brief Execute up to count commands in one call, writing their output to the log at once.
+ * @param count Maximum number of commands to execute.
+ * @return Number of commands executed.
+ */
+int Process::executeCommands(int count)
+{
+    int end = std::min(command_counter_ + count, static_cast<int>(command_list_.size()));
+    int executed = std::max(end - command_counter_, 0);
+
+    CommandBatch batch;
+    batch.core = cpu_core_id_;
+    for (; command_counter_ < end; ++command_counter_)
+    {
+        command_list_[command_counter_]->executeBatched(batch);
+    }
+
+    if (!batch.output.empty())
+    {
+        std::ofstream outfile(name_ + ".txt", std::ios::app);
+        outfile << batch.output;
+    }
+
+    return executed;
+}
+
 /**
  * @brief Calculate the number of frames required by the process.
  */
@@ -148,15 +177,10 @@ std::string Process::getTime() const
 
 /**
  * @brief Generate print commands for the process.
- * @param min_ins Minimum number of instructions.
- * @param max_ins Maximum number of instructions.
+ * @param num_commands Number of instructions; ProcessManager draws it so runs can be seeded.
  */
-void Process::generateCommands(int min_ins, int max_ins)
+void Process::generateCommands(int num_commands)
 {
-    std::srand(static_cast<unsigned int>(std::time(nullptr)) + pid_);
-
-    int num_commands = min_ins + (std::rand() % (max_ins - min_ins + 1));
-
     for (int i = 1; i <= num_commands; ++i)
     {
         std::shared_ptr<ICommand> cmd = std::make_shared<PrintCommand>(pid_, cpu_core_id_, "Hello World From " + name_ + " started.", name_);
@@ -189,3 +213,273 @@ size_t Process::getNumPages() const
 {
     return num_pages_;
 }
+
+/**
+ * @brief Getter for the scheduling priority level.
+ * @return The priority level, 0 being the highest.
+ */
+int Process::getPriorityLevel() const
+{
+    return priority_level_;
+}
+
+/**
+ * @brief Set the scheduling priority level.
+ * @param level The new priority level.
+ */
+void Process::setPriorityLevel(int level)
+{
+    priority_level_ = level;
+}
+
+/**
+ * @brief Getter for the tick at which the process last became ready.
+ * @return The tick.
+ */
+int Process::getReadySince() const
+{
+    return ready_since_;
+}
+
+/**
+ * @brief Record the tick at which the process became ready.
+ * @param tick The current tick.
+ */
+void Process::setReadySince(int tick)
+{
+    ready_since_ = tick;
+}
+
+/**
+ * @brief Getter for the tick at which the process was admitted.
+ * @return The tick.
+ */
+int Process::getArrivalTick() const
+{
+    return arrival_tick_;
+}
+
+/**
+ * @brief Record the tick at which the process was admitted.
+ * @param tick The current tick.
+ */
+void Process::setArrivalTick(int tick)
+{
+    arrival_tick_ = tick;
+}
+
+/**
+ * @brief Getter for the virtual runtime.
+ * @return The virtual runtime in ticks.
+ */
+int Process::getVirtualRuntime() const
+{
+    return vruntime_;
+}
+
+/**
+ * @brief Set the virtual runtime, e.g. when a fair scheduler admits the process.
+ * @param vruntime The virtual runtime in ticks.
+ */
+void Process::setVirtualRuntime(int vruntime)
+{
+    vruntime_ = vruntime;
+}
+
+/**
+ * @brief Charge CPU time to the virtual runtime.
+ * @param ticks The ticks the process just ran for.
+ */
+void Process::addVirtualRuntime(int ticks)
+{
+    vruntime_ += ticks;
+}
+
+/**
+ * @brief Get the core whose min_vruntime the virtual runtime is measured against.
+ * @return The core ID, or 0 if the process has not been queued on a core yet.
+ */
+int Process::getVruntimeCore() const
+{
+    return vruntime_core_;
+}
+
+/**
+ * @brief Set the core whose min_vruntime the virtual runtime is measured against.
+ * @param core The core ID.
+ */
+void Process::setVruntimeCore(int core)
+{
+    vruntime_core_ = core;
+}
+
+/**
+ * @brief Getter for the proportional-share tickets.
+ * @return The number of tickets.
+ */
+int Process::getTickets() const
+{
+    return tickets_;
+}
+
+/**
+ * @brief Set the proportional-share tickets.
+ * @param tickets The number of tickets.
+ */
+void Process::setTickets(int tickets)
+{
+    tickets_ = tickets;
+}
+
+/**
+ * @brief Getter for the stride scheduling pass value.
+ * @return The pass value.
+ */
+long long Process::getPass() const
+{
+    return pass_;
+}
+
+/**
+ * @brief Set the stride scheduling pass value.
+ * @param pass The pass value.
+ */
+void Process::setPass(long long pass)
+{
+    pass_ = pass;
+}
+
+/**
+ * @brief Getter for the deadline.
+ * @return Ticks after arrival by which the process should finish, or 0 if it has none.
+ */
+int Process::getDeadline() const
+{
+    return deadline_;
+}
+
+/**
+ * @brief Set the deadline.
+ * @param ticks Ticks after arrival by which the process should finish, or 0 for none.
+ */
+void Process::setDeadline(int ticks)
+{
+    deadline_ = ticks;
+}
+
+/**
+ * @brief Getter for the number of migrations.
+ * @return Times the process resumed on a different core than it last ran on.
+ */
+int Process::getMigrations() const
+{
+    return migrations_;
+}
+
+/**
+ * @brief Count a migration to another core.
+ */
+void Process::addMigration()
+{
+    migrations_++;
+}
+
+/**
+ * @brief Getter for the memory stall time.
+ * @return Ticks the process spent waiting for memory.
+ */
+int Process::getMemoryStall() const
+{
+    return memory_stall_;
+}
+
+/**
+ * @brief Charge time spent waiting for memory.
+ * @param ticks The ticks the process just waited.
+ */
+void Process::addMemoryStall(int ticks)
+{
+    memory_stall_ += ticks;
+}
+
+/**
+ * @brief Getter for the tick of the first dispatch.
+ * @return The tick, or -1 if the process has not run yet.
+ */
+int Process::getFirstRunTick() const
+{
+    return first_run_tick_;
+}
+
+/**
+ * @brief Setter for the tick of the first dispatch.
+ * @param tick The tick the process first got a core.
+ */
+void Process::setFirstRunTick(int tick)
+{
+    first_run_tick_ = tick;
+}
+
+/**
+ * @brief Getter for the completion tick.
+ * @return The tick, or -1 if the process has not finished.
+ */
+int Process::getFinishTick() const
+{
+    return finish_tick_;
+}
+
+/**
+ * @brief Setter for the completion tick.
+ * @param tick The tick the process finished.
+ */
+void Process::setFinishTick(int tick)
+{
+    finish_tick_ = tick;
+}
+
+/**
+ * @brief Getter for the time spent waiting in ready queues.
+ * @return Ticks the process was ready but not running.
+ */
+int Process::getWaitTicks() const
+{
+    return wait_ticks_;
+}
+
+/**
+ * @brief Charge time spent waiting in a ready queue.
+ * @param ticks The ticks the process just waited before being dispatched.
+ */
+void Process::addWaitTicks(int ticks)
+{
+    wait_ticks_ += ticks;
+}
+
+/**
+ * @brief Getter for the number of preemptions.
+ * @return Times the process was taken off a core before finishing.
+ */
+int Process::getPreemptions() const
+{
+    return preemptions_;
+}
+
+/**
+ * @brief Getter for the tick of the latest preemption.
+ * @return The tick, or -1 if the process was never preempted.
+ */
+int Process::getLastPreemptTick() const
+{
+    return last_preempt_tick_;
+}
+
+/**
+ * @brief Count a preemption.
+ * @param tick The tick the process was taken off its core.
+ */
+void Process::addPreemption(int tick)
+{
+    preemptions_++;
+    last_preempt_tick_ = tick;
+}
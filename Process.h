@@ -4,6 +4,7 @@
 #include "ICommand.h"
 #include "PrintCommand.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -49,8 +50,9 @@ public:
     // Constructor
     Process(int pid, const std::string& name, const std::string& time, int core, int min_ins, int max_ins, size_t mem_per_proc, size_t mem_per_frame);
 
-    // Method to execute the current command
+    // Methods to execute the current command, or a batch of commands
     void executeCurrentCommand();
+    int executeCommands(int count);
 
     // Getters and Setters
     int getCommandCounter() const;
@@ -69,9 +71,39 @@ public:
     std::chrono::time_point<std::chrono::system_clock> getAllocTime() const;
     size_t getNumPages() const;
     void calculateFrame();
+    int getPriorityLevel() const;
+    void setPriorityLevel(int level);
+    int getReadySince() const;
+    void setReadySince(int tick);
+    int getArrivalTick() const;
+    void setArrivalTick(int tick);
+    int getVirtualRuntime() const;
+    void setVirtualRuntime(int vruntime);
+    void addVirtualRuntime(int ticks);
+    int getVruntimeCore() const;
+    void setVruntimeCore(int core);
+    int getTickets() const;
+    void setTickets(int tickets);
+    long long getPass() const;
+    void setPass(long long pass);
+    int getDeadline() const;
+    void setDeadline(int ticks);
+    int getMigrations() const;
+    void addMigration();
+    int getMemoryStall() const;
+    void addMemoryStall(int ticks);
+    int getFirstRunTick() const;
+    void setFirstRunTick(int tick);
+    int getFinishTick() const;
+    void setFinishTick(int tick);
+    int getWaitTicks() const;
+    void addWaitTicks(int ticks);
+    int getPreemptions() const;
+    int getLastPreemptTick() const;
+    void addPreemption(int tick);
 
     // Method to generate print commands
-    void generateCommands(int min_ins, int max_ins);
+    void generateCommands(int num_commands);
 
 private:
     size_t pid_;                        ///< Process ID.
@@ -86,8 +118,28 @@ private:
     int command_counter_ = 0;           ///< Command counter.
     int cpu_core_id_;                   ///< CPU core ID assigned to the process.
     RequirementFlags requirement_flags_; ///< Flags indicating process requirements.
-    ProcessState process_state_;        ///< Current state of the process.
-    void* memory_;                      ///< Pointer to the memory allocated to the process.
+    std::atomic<ProcessState> process_state_; ///< Current state of the process; read by eviction on other cores.
+    std::atomic<void*> memory_;         ///< Pointer to the memory allocated to the process.
+    int priority_level_ = 0;            ///< Scheduling priority level, 0 being the highest.
+    int ready_since_ = 0;               ///< Tick at which the process last became ready.
+    int arrival_tick_ = 0;              ///< Tick at which the process was admitted.
+    int vruntime_ = 0;                  ///< Virtual runtime: ticks of CPU received, offset on admission by CFS.
+    int vruntime_core_ = 0;             ///< Core whose min_vruntime the virtual runtime is measured against, 0 for none.
+    int tickets_ = 1;                   ///< Proportional-share tickets.
+    long long pass_ = 0;                ///< Stride scheduling pass value.
+    int deadline_ = 0;                  ///< Deadline in ticks after arrival, 0 for best-effort.
+    int migrations_ = 0;                ///< Times the process resumed on a different core.
+    int memory_stall_ = 0;              ///< Ticks spent in the memory-wait queue.
+    int first_run_tick_ = -1;           ///< Tick of the first dispatch, -1 before it.
+    int finish_tick_ = -1;              ///< Tick the last instruction ran, -1 before it.
+    int wait_ticks_ = 0;                ///< Ticks spent ready but not running.
+    int preemptions_ = 0;               ///< Times the process was taken off a core unfinished.
+    int last_preempt_tick_ = -1;        ///< Tick of the latest preemption, -1 if none.
+
+    friend class AgeList;
+    Process* age_older_ = nullptr;      ///< Next older resident process, see AgeList.
+    Process* age_newer_ = nullptr;      ///< Next newer resident process, see AgeList.
+    bool age_linked_ = false;           ///< Whether the process is in an AgeList.
 };
 
 #endif
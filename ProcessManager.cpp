@@ -2,28 +2,29 @@
 #include "CoreStateManager.h"
 #include <random>
 #include <cmath>
+#include <sstream>
 
 /**
  * @brief Constructor for ProcessManager.
  */
 ProcessManager::ProcessManager(int min_ins, int max_ins, int n_cpu, std::string scheduler_algo, int delays_per_exec,
                                int quantum_cycle, Clock* cpu_clock, size_t max_mem, size_t mem_per_frame,
-                               size_t min_mem_per_proc, size_t max_mem_per_proc)
+                               size_t min_mem_per_proc, size_t max_mem_per_proc, int context_switch_ticks,
+                               int migration_cost_ticks, const PolicyConfig& policy_config, unsigned seed, RunLog* run_log)
     : min_ins_(min_ins), max_ins_(max_ins), cpu_clock(cpu_clock), 
       min_mem_per_proc_(min_mem_per_proc), max_mem_per_proc_(max_mem_per_proc),
-      max_mem_(max_mem), mem_per_frame_(mem_per_frame), num_cpu_(n_cpu)
+      max_mem_(max_mem), mem_per_frame_(mem_per_frame), num_cpu_(n_cpu),
+      rng_(seed != 0 ? seed : std::random_device()()), run_log_(run_log)
 {
-    if (max_mem == mem_per_frame)
-    {
-        memory_allocator_ = new FlatMemoryAllocator(max_mem, mem_per_frame);
-    }
-    else
-    {
-        memory_allocator_ = new PagingAllocator(max_mem, mem_per_frame);
-    }
+    // A single frame as large as memory means no paging
+    memory_allocator_ = AllocatorRegistry::create(max_mem == mem_per_frame ? "flat" : "paging", max_mem, mem_per_frame).release();
 
     scheduler_ = new Scheduler(scheduler_algo, delays_per_exec, n_cpu, quantum_cycle, cpu_clock, memory_allocator_);
+    scheduler_->setPolicyConfig(policy_config);
     scheduler_->setNumCPUs(n_cpu);
+    scheduler_->setContextSwitchTicks(context_switch_ticks);
+    scheduler_->setMigrationCostTicks(migration_cost_ticks);
+    scheduler_->setRunLog(run_log);
 
     scheduler_thread_ = std::thread(&Scheduler::start, scheduler_);
 }
@@ -31,13 +32,60 @@ ProcessManager::ProcessManager(int min_ins, int max_ins, int n_cpu, std::string
 /**
  * @brief Adds a new process to the system.
  */
-void ProcessManager::addProcess(std::string name, std::string time)
+void ProcessManager::addProcess(std::string name, std::string time, int deadline)
+{
+    std::lock_guard<std::mutex> lock(process_list_mutex_);
+
+    WorkloadTrace::Record record;
+    record.instructions = std::uniform_int_distribution<int>(min_ins_, max_ins_)(rng_);
+    record.memory_kb = generateMemory();
+    record.deadline = deadline;
+    admitProcess(name, time, record);
+}
+
+/**
+ * @brief Adds a process described by a workload trace record.
+ * @return False if the process needs more memory than the system has; it is not added.
+ */
+bool ProcessManager::addProcess(std::string name, std::string time, const WorkloadTrace::Record& record)
+{
+    // It could never be loaded, and would wait for memory forever
+    if (record.memory_kb > max_mem_)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(process_list_mutex_);
+    admitProcess(name, time, record);
+    return true;
+}
+
+/**
+ * @brief Creates a process, logs its admission if the run is recorded or replayed, and hands it to the scheduler.
+ * Called with process_list_mutex_ held.
+ */
+void ProcessManager::admitProcess(const std::string& name, const std::string& time, const WorkloadTrace::Record& record)
 {
+    if (run_log_)
+    {
+        run_log_->begin(RunLog::GENERATOR);
+    }
+
     pid_counter_++;
-    auto process = std::make_shared<Process>(pid_counter_, name, time, -1, min_ins_, max_ins_, generateMemory(), mem_per_frame_);
+    auto process = std::make_shared<Process>(pid_counter_, name, time, -1, record.instructions, record.instructions, record.memory_kb, mem_per_frame_);
     process_list_[name] = process;
-    process->generateCommands(min_ins_, max_ins_);
+    process->generateCommands(record.instructions);
+    if (record.priority >= 0)
+    {
+        process->setPriorityLevel(record.priority);
+    }
+    process->setDeadline(record.deadline);
     scheduler_->addProcess(process);
+
+    if (run_log_)
+    {
+        run_log_->end(RunLog::GENERATOR, RunLog::ADMIT, pid_counter_, record.instructions, &record);
+    }
 }
 
 /**
@@ -52,6 +100,17 @@ std::shared_ptr<Process> ProcessManager::getProcess(std::string name)
     return nullptr;
 }
 
+/**
+ * @brief Grows or shrinks the number of online cores without stopping the scheduler.
+ * Processes on removed cores move to the remaining ones; nothing is lost.
+ */
+int ProcessManager::setNumCPUs(int num)
+{
+    scheduler_->setOnlineCores(num);
+    num_cpu_ = scheduler_->getNumCPUs();
+    return num_cpu_;
+}
+
 /**
  * @brief Retrieves all processes in the system.
  */
@@ -106,6 +165,10 @@ void ProcessManager::processSmi()
     std::cout << "Memory Usage: " << memory_usage << "KB" << " / " << max_mem_ << "KB" << std::endl;
     std::cout << "Memory Util: " << (static_cast<double>(memory_usage) / max_mem_) * 100 << "%" << std::endl;
 
+    printCoreLoad(std::cout);
+    printSchedulingMetrics(std::cout);
+    scheduler_->getPolicy().report(std::cout);
+
     std::cout << "============================================\n"; 
     std::cout << "Running processes and memory usage:\n";
     std::cout << "--------------------------------------------\n";
@@ -115,17 +178,24 @@ void ProcessManager::processSmi()
 }
 
 /**
- * @brief Generates the memory required for a new process.
+ * @brief Prints mean, p50 and p99 wait, response and turnaround of finished processes.
+ * @param out Output stream to print to.
+ */
+void ProcessManager::printSchedulingMetrics(std::ostream& out)
+{
+    scheduler_->getMetrics().report(out, cpu_clock->getCpuClock());
+}
+
+/**
+ * @brief Generates the memory required for a new process. Called with process_list_mutex_ held.
  * @return The memory size for the process.
  */
 size_t ProcessManager::generateMemory()
 {
-    std::random_device rd;
-    std::mt19937 gen(rd());
     size_t min_exp = static_cast<size_t>(std::log2(min_mem_per_proc_));
     size_t max_exp = static_cast<size_t>(std::log2(max_mem_per_proc_));
     std::uniform_int_distribution<size_t> dist(min_exp, max_exp);
-    size_t exp = dist(gen);
+    size_t exp = dist(rng_);
     return static_cast<size_t>(std::pow(2, exp));
 }
 
@@ -136,14 +206,83 @@ void ProcessManager::vmStat()
 {
     static std::mutex process_list_mutex;
 
+    // Read each counter once so idle + active always adds up to the total shown
+    int total_ticks = cpu_clock->getCpuClock();
+    int active_ticks = cpu_clock->getActiveCpuNum();
+
     std::cout << "==========================================" << std::endl;
     std::cout << std::setw(12) << max_mem_ << " KB total memory" << std::endl;
     std::cout << std::setw(12) << max_mem_ - memory_allocator_->getExternalFragmentation() << " KB used memory" << std::endl;
     std::cout << std::setw(12) << memory_allocator_->getExternalFragmentation() << " KB free memory" << std::endl;
-    std::cout << std::setw(12) << cpu_clock->getCpuClock() - cpu_clock->getActiveCpuNum() << " idle cpu ticks" << std::endl;
-    std::cout << std::setw(12) << cpu_clock->getActiveCpuNum() << " active cpu ticks" << std::endl;
-    std::cout << std::setw(12) << cpu_clock->getCpuClock() << " total cpu ticks" << std::endl;
+    std::cout << std::setw(12) << total_ticks - active_ticks << " idle cpu ticks" << std::endl;
+    std::cout << std::setw(12) << active_ticks << " active cpu ticks" << std::endl;
+    std::cout << std::setw(12) << total_ticks << " total cpu ticks" << std::endl;
     std::cout << std::setw(12) << memory_allocator_->getPageIn() << " pages paged in" << std::endl;
     std::cout << std::setw(12) << memory_allocator_->getPageOut() << " pages paged out" << std::endl;
+
+    long long context_switches = 0;
+    long long context_switch_ticks = 0;
+    long long migrations = 0;
+    long long migration_ticks = 0;
+    // Cores taken offline keep what they counted
+    for (int core_id = 1; core_id <= scheduler_->getCoreSlots(); ++core_id)
+    {
+        context_switches += scheduler_->getCoreLoad(core_id).getContextSwitches();
+        context_switch_ticks += scheduler_->getCoreLoad(core_id).getContextSwitchTicks();
+        migrations += scheduler_->getCoreLoad(core_id).getMigrations();
+        migration_ticks += scheduler_->getCoreLoad(core_id).getMigrationTicks();
+    }
+    std::cout << std::setw(12) << context_switches << " context switches" << std::endl;
+    std::cout << std::setw(12) << context_switch_ticks << " context switch ticks" << std::endl;
+    std::cout << std::setw(12) << migrations << " migrations" << std::endl;
+    std::cout << std::setw(12) << migration_ticks << " migration ticks" << std::endl;
+    std::cout << std::setw(12) << scheduler_->getFinishedProcesses() << " finished processes" << std::endl;
+    std::cout << std::setw(12) << scheduler_->getMemoryWaiting() << " processes waiting for memory" << std::endl;
+    std::cout << std::setw(12) << scheduler_->getMemoryStallTicks() << " memory stall ticks" << std::endl;
+
+    std::ostringstream turnaround;
+    turnaround << std::fixed << std::setprecision(1) << scheduler_->getMeanTurnaround();
+    std::cout << std::setw(12) << turnaround.str() << " mean turnaround ticks" << std::endl;
+
+    printCoreLoad(std::cout);
     std::cout << "==========================================" << std::endl;
 }
+
+/**
+ * @brief Prints per-core busy ticks, utilization, run-queue averages and migrations.
+ * @param out Output stream to print to.
+ */
+void ProcessManager::printCoreLoad(std::ostream& out)
+{
+    int now = cpu_clock->getCpuClock();
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << "------------------------------------------" << std::endl;
+    out << "Core   Busy ticks   Util 1s / 10s / 60s     RunQ 1s / 10s / 60s    Migr" << std::endl;
+
+    for (int core_id = 1; core_id <= scheduler_->getCoreSlots(); ++core_id)
+    {
+        const CoreLoad& load = scheduler_->getCoreLoad(core_id);
+
+        out << std::setw(4) << core_id << std::setw(13) << load.getBusyTicks(now) << "  ";
+        for (double utilization : load.getUtilization(now))
+        {
+            out << std::setw(6) << std::fixed << std::setprecision(1) << utilization * 100 << "%";
+        }
+        out << " ";
+        for (double length : scheduler_->getRunQueueLoad(core_id).get(now))
+        {
+            out << ' ' << std::setw(7) << std::fixed << std::setprecision(2) << length;
+        }
+        out << ' ' << std::setw(7) << load.getMigrations();
+        if (!scheduler_->isCoreOnline(core_id))
+        {
+            out << "  offline";
+        }
+        out << std::endl;
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -6,9 +6,12 @@
 #include "Clock.h"
 #include "FlatMemoryAllocator.h"
 #include "PagingAllocator.h"
+#include "RunLog.h"
+#include "WorkloadTrace.h"
 
 #include <map>
 #include <memory>
+#include <random>
 #include <vector>
 #include <iostream>
 #include <thread>
@@ -38,6 +41,8 @@ private:
     IMemoryAllocator* memory_allocator_;                           ///< Pointer to memory allocator.
     int num_cpu_;                                                  ///< Number of CPU cores.
     std::mutex process_list_mutex_;                                ///< Mutex for protecting access to process list.
+    std::mt19937 rng_;                                             ///< Draws process sizes; guarded by process_list_mutex_.
+    RunLog* run_log_;                                              ///< Log of the run being recorded or replayed, or nullptr.
     std::mutex core_states_mutex_;                                 ///< Mutex for protecting core state operations.
 
     /**
@@ -46,6 +51,21 @@ private:
      */
     size_t generateMemory();
 
+    /**
+     * @brief Creates a process, logs its admission if the run is recorded or replayed, and hands it to the scheduler.
+     * Called with process_list_mutex_ held.
+     * @param name Name of the process.
+     * @param time Time of creation.
+     * @param record Instruction count, memory, priority and deadline of the process.
+     */
+    void admitProcess(const std::string& name, const std::string& time, const WorkloadTrace::Record& record);
+
+    /**
+     * @brief Prints per-core busy ticks, utilization and run-queue averages.
+     * @param out Output stream to print to.
+     */
+    void printCoreLoad(std::ostream& out);
+
 public:
     /**
      * @brief Constructor for ProcessManager.
@@ -60,17 +80,34 @@ public:
      * @param mem_per_frame Memory per frame for paging.
      * @param min_mem_per_proc Minimum memory per process.
      * @param max_mem_per_proc Maximum memory per process.
+     * @param context_switch_ticks Ticks charged to a core for each context switch.
+     * @param migration_cost_ticks Ticks charged to a core that resumes a process from another core.
+     * @param policy_config Policy-specific settings.
+     * @param seed Seed of the generated process sizes, 0 to seed from the host.
+     * @param run_log Log to record the run to or replay it from, already opened; nullptr for none.
      */
     ProcessManager(int min_ins, int max_ins, int n_cpu, std::string scheduler_algo, int delays_per_exec,
                    int quantum_cycle, Clock* cpu_clock, size_t max_mem, size_t mem_per_frame, 
-                   size_t min_mem_per_proc, size_t max_mem_per_proc);
+                   size_t min_mem_per_proc, size_t max_mem_per_proc, int context_switch_ticks = 0,
+                   int migration_cost_ticks = 0, const PolicyConfig& policy_config = PolicyConfig(),
+                   unsigned seed = 0, RunLog* run_log = nullptr);
 
     /**
      * @brief Adds a new process to the system.
      * @param name Name of the process.
      * @param time Time of creation.
+     * @param deadline Deadline in ticks after arrival, 0 for none.
      */
-    void addProcess(std::string name, std::string time);
+    void addProcess(std::string name, std::string time, int deadline = 0);
+
+    /**
+     * @brief Adds a process described by a workload trace record.
+     * @param name Name of the process.
+     * @param time Time of creation.
+     * @param record Instruction count, memory, priority and deadline of the process.
+     * @return False if the process needs more memory than the system has; it is not added.
+     */
+    bool addProcess(std::string name, std::string time, const WorkloadTrace::Record& record);
 
     /**
      * @brief Retrieves a process by its name.
@@ -87,7 +124,7 @@ public:
 
     /**
      * @brief Destructor for ProcessManager.
-     * Ensures that the scheduler thread is stopped before destruction.
+     * Ensures that the scheduler thread is stopped before the scheduler and allocator are freed.
      */
     ~ProcessManager()
     {
@@ -96,13 +133,46 @@ public:
             scheduler_->stop();
             scheduler_thread_.join();
         }
+        delete scheduler_;
+        delete memory_allocator_;
     }
 
+    /**
+     * @brief Get the scheduler, for reading its statistics.
+     * @return Reference to the scheduler.
+     */
+    const Scheduler& getScheduler() const
+    {
+        return *scheduler_;
+    }
+
+    /**
+     * @brief Get the memory allocator, for reading its statistics.
+     * @return Reference to the memory allocator.
+     */
+    IMemoryAllocator& getMemoryAllocator()
+    {
+        return *memory_allocator_;
+    }
+
+    /**
+     * @brief Grows or shrinks the number of online cores without stopping the scheduler.
+     * @param num The new number of cores.
+     * @return The number of cores now online.
+     */
+    int setNumCPUs(int num);
+
     /**
      * @brief Prints system memory and process information statistics.
      */
     void processSmi();
 
+    /**
+     * @brief Prints mean, p50 and p99 wait, response and turnaround of finished processes.
+     * @param out Output stream to print to.
+     */
+    void printSchedulingMetrics(std::ostream& out);
+
     /**
      * @brief Prints system memory statistics in a formatted style.
      */
@@ -0,0 +1,109 @@
+#ifndef QUEUED_POLICY_H
+#define QUEUED_POLICY_H
+
+#include "ReadyQueues.h"
+#include "Scheduler.h"
+#include "SchedulingPolicy.h"
+
+#include <algorithm>
+#include <memory>
+
+/**
+ * @class QueuedPolicy
+ * @brief Base for policies built on per-core ready queues.
+ *
+ * Supplies the hooks Scheduler::schedule<Policy> calls, with defaults that pick from the core's
+ * queue and requeue preempted processes onto the same core (see ReadyQueues::requeue). A policy derives from this with
+ * itself as Derived, picks the queue container that gives its order, and shadows the hooks it
+ * needs; the calls are resolved at compile time.
+ *
+ * Hooks used by the dispatch loop:
+ * - pickNext(core_id): next process for the core, or nullptr.
+ * - timeSlice(process, core_id): instructions to run before preempting. Required.
+ * - keepRunning(process, core_id): at the end of a slice, whether the process may run another
+ *   slice without a context switch.
+ * - requeue(process, core_id, ticks): put a preempted process back after it ran for ticks.
+ * - finish(process, core_id, ticks): a process ran its last instruction.
+ *
+ * @tparam Derived The concrete policy.
+ * @tparam Queue The per-core container, see ReadyQueues.
+ */
+template <typename Derived, typename Queue = FifoQueue>
+class QueuedPolicy : public SchedulingPolicy
+{
+public:
+    /**
+     * @brief Constructor for QueuedPolicy.
+     * @param config The policy settings.
+     */
+    explicit QueuedPolicy(const PolicyConfig& config)
+        : config_(config), queues_(std::max(config.max_cpus, config.num_cpus), config.num_cpus, config.cpu_clock, config.requeue_affinity)
+    {
+    }
+
+    void runCore(Scheduler& scheduler, int core_id, int tick_slot) override
+    {
+        scheduler.schedule(static_cast<Derived&>(*this), core_id, tick_slot);
+    }
+
+    void admit(std::shared_ptr<Process> process) override
+    {
+        queues_.admit(std::move(process));
+    }
+
+    void resume(std::shared_ptr<Process> process, int core_id) override
+    {
+        queues_.push(std::move(process), core_id);
+    }
+
+    void setOnlineCores(int count) override
+    {
+        queues_.setOnlineCores(count);
+    }
+
+    int drainCore(int core_id) override
+    {
+        return queues_.drain(core_id);
+    }
+
+    const LoadAverage& getQueueLoad(int core_id) const override
+    {
+        return queues_.getLoad(core_id);
+    }
+
+    std::shared_ptr<Process> pickNext(int core_id)
+    {
+        return queues_.pop(core_id);
+    }
+
+    bool hasWork() const override
+    {
+        return queues_.any();
+    }
+
+    bool keepRunning(const Process& process, int core_id)
+    {
+        (void)process;
+        (void)core_id;
+        return false;
+    }
+
+    void requeue(std::shared_ptr<Process> process, int core_id, int ticks)
+    {
+        (void)ticks;
+        queues_.requeue(std::move(process), core_id);
+    }
+
+    void finish(const std::shared_ptr<Process>& process, int core_id, int ticks)
+    {
+        (void)process;
+        (void)core_id;
+        (void)ticks;
+    }
+
+protected:
+    PolicyConfig config_;        ///< The policy settings.
+    ReadyQueues<Queue> queues_;  ///< Per-core ready queues.
+};
+
+#endif
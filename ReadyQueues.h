@@ -0,0 +1,508 @@
+#ifndef READY_QUEUES_H
+#define READY_QUEUES_H
+
+#include "Clock.h"
+#include "CoreLoad.h"
+#include "MpmcQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Process;
+
+/**
+ * @class FifoQueue
+ * @brief First-in first-out container of ready processes.
+ */
+class FifoQueue
+{
+public:
+    void push(std::shared_ptr<Process> process)
+    {
+        processes_.push_back(std::move(process));
+    }
+
+    std::shared_ptr<Process> pop()
+    {
+        std::shared_ptr<Process> process = std::move(processes_.front());
+        processes_.pop_front();
+        return process;
+    }
+
+    size_t size() const
+    {
+        return processes_.size();
+    }
+
+private:
+    std::deque<std::shared_ptr<Process>> processes_; ///< Ready processes, oldest first.
+};
+
+/**
+ * @class ReadyQueues
+ * @brief Per-core ready queues with a lock-free admission ring and work stealing.
+ *
+ * New processes enter through a bounded lock-free ring, so admission never takes a lock a busy
+ * core might hold. Each time a core picks, it moves its share of the ring (an equal split over
+ * the online cores, at least one) into its own queue, so the container's order covers newcomers
+ * soon without one core taking every arrival, and an idle core steals from the longest other
+ * queue. The container decides the order within a core.
+ *
+ * With affinity on, a preempted process goes back to the queue of the core it ran on. With
+ * affinity off it goes back through the admission ring to whichever core picks next. Either way
+ * a core that picks while the longest queue is more than REBALANCE_THRESHOLD processes longer
+ * than its own first pulls half the difference over, so queues cannot drift apart on cores that
+ * are never idle.
+ *
+ * A policy whose order is relative to each core can set an enter hook, which is called whenever a
+ * process is queued on a core or stolen to run there, before the core's container sees it.
+ *
+ * Queues exist for every core up to a fixed capacity, but only the online cores take overflow
+ * admissions. A core going offline hands its queue to the others with drain(); stealing still
+ * looks at every core that was ever online, so nothing left behind is lost.
+ *
+ * @tparam Queue Container with push(process), pop() and size(); pop() is only called when non-empty.
+ */
+template <typename Queue>
+class ReadyQueues
+{
+public:
+    static constexpr size_t ADMISSION_CAPACITY = 1024; ///< Size of the admission ring.
+    static constexpr int REBALANCE_THRESHOLD = 4;      ///< Queue length difference a picking core evens out.
+
+    using EnterHook = std::function<void(Process&, int)>; ///< Called with a process and the core it is placed on.
+
+    /**
+     * @brief Constructor for ReadyQueues.
+     * @param max_cores Most cores that can be online; queues are indexed from 1.
+     * @param num_cores Number of cores online at first.
+     * @param cpu_clock Clock used to time the queue-length averages.
+     * @param affinity Whether preempted processes return to the core they ran on.
+     */
+    ReadyQueues(int max_cores, int num_cores, Clock* cpu_clock, bool affinity = true)
+        : max_cores_(std::max(max_cores, 1)), affinity_(affinity), cpu_clock_(cpu_clock),
+          queues_(new CoreQueue[std::max(max_cores, 1) + 1]), admission_(ADMISSION_CAPACITY)
+    {
+        setOnlineCores(num_cores);
+    }
+
+    /**
+     * @brief Set the hook called whenever a process is queued on, or stolen to run on, a core.
+     * @param hook The hook, or an empty function for none.
+     */
+    void setEnterHook(EnterHook hook)
+    {
+        enter_ = std::move(hook);
+    }
+
+    /**
+     * @brief Set how many cores are online. Cores 1 to count take work.
+     * @param count Number of online cores, clamped to the capacity.
+     */
+    void setOnlineCores(int count)
+    {
+        count = std::clamp(count, 1, max_cores_);
+        online_cores_ = count;
+
+        // Queues past the online cores may still hold processes until they are drained
+        int seen = seen_cores_.load();
+        while (count > seen && !seen_cores_.compare_exchange_weak(seen, count))
+        {
+        }
+    }
+
+    /**
+     * @brief Get the number of online cores.
+     * @return The count.
+     */
+    int getOnlineCores() const
+    {
+        return online_cores_.load();
+    }
+
+    /**
+     * @brief Move every process queued on a core to the online cores, in turn.
+     * @param core_id The core giving up its queue.
+     * @return Number of processes moved.
+     */
+    int drain(int core_id)
+    {
+        std::vector<std::shared_ptr<Process>> moved;
+        {
+            CoreQueue& queue = queues_[core_id];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            while (queue.processes.size() > 0)
+            {
+                moved.push_back(queue.processes.pop());
+            }
+            updateSize(queue);
+        }
+
+        for (std::shared_ptr<Process>& process : moved)
+        {
+            push(std::move(process), nextOnlineCore());
+        }
+        return static_cast<int>(moved.size());
+    }
+
+    /**
+     * @brief Admit a new process. Falls back to the cores' queues in turn if the ring is full.
+     * @param process The new process.
+     */
+    void admit(std::shared_ptr<Process> process)
+    {
+        if (!admission_.tryPush(process))
+        {
+            push(std::move(process), nextOnlineCore());
+        }
+    }
+
+    /**
+     * @brief Push a process onto a core's queue.
+     * @param process The process.
+     * @param core_id The core whose queue receives the process.
+     */
+    void push(std::shared_ptr<Process> process, int core_id)
+    {
+        enter(*process, core_id);
+
+        CoreQueue& queue = queues_[core_id];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.processes.push(std::move(process));
+        updateSize(queue);
+    }
+
+    /**
+     * @brief Queue a preempted process again, on the core it ran on if affinity is on.
+     * @param process The process.
+     * @param core_id The core it ran on.
+     */
+    void requeue(std::shared_ptr<Process> process, int core_id)
+    {
+        if (affinity_)
+        {
+            push(std::move(process), core_id);
+        }
+        else
+        {
+            admit(std::move(process));
+        }
+    }
+
+    /**
+     * @brief Pick the next process for a core: its share of pending admissions is merged into
+     * its queue and the queue is evened out against the longest one first, then the core's own
+     * queue is popped, then the longest other queue is stolen from.
+     * @param core_id The core asking for work.
+     * @return The process, or nullptr if nothing is ready anywhere.
+     */
+    std::shared_ptr<Process> pop(int core_id)
+    {
+        mergeAdmission(core_id);
+        rebalance(core_id);
+
+        std::shared_ptr<Process> process = popFrom(core_id);
+        if (process)
+        {
+            return process;
+        }
+
+        while (true)
+        {
+            int victim = 0;
+            int longest = 0;
+
+            int seen = seen_cores_.load();
+            for (int i = 1; i <= seen; ++i)
+            {
+                int size = queues_[i].size.load();
+                if (i != core_id && size > longest)
+                {
+                    victim = i;
+                    longest = size;
+                }
+            }
+
+            if (victim == 0)
+            {
+                return nullptr;
+            }
+
+            // The victim may have drained in the meantime; look again
+            process = popFrom(victim);
+            if (process)
+            {
+                enter(*process, core_id);
+                return process;
+            }
+        }
+    }
+
+    /**
+     * @brief Move a core's share of the admitted processes waiting in the ring into its queue:
+     * the ring split evenly over the online cores, and at least one process.
+     * @param core_id The core taking the processes.
+     */
+    void mergeAdmission(int core_id)
+    {
+        std::shared_ptr<Process> admitted;
+        if (!admission_.tryPop(admitted))
+        {
+            return;
+        }
+
+        size_t share = admission_.sizeApprox() / static_cast<size_t>(online_cores_.load()) + 1;
+
+        CoreQueue& queue = queues_[core_id];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        enter(*admitted, core_id);
+        queue.processes.push(std::move(admitted));
+        for (size_t taken = 1; taken < share && admission_.tryPop(admitted); ++taken)
+        {
+            enter(*admitted, core_id);
+            queue.processes.push(std::move(admitted));
+        }
+        updateSize(queue);
+    }
+
+    /**
+     * @brief Move every admitted process waiting in the ring to the online cores' queues, in turn.
+     * Used before a change that has to reach every ready process.
+     */
+    void spreadAdmission()
+    {
+        std::shared_ptr<Process> admitted;
+        while (admission_.tryPop(admitted))
+        {
+            push(std::move(admitted), nextOnlineCore());
+        }
+    }
+
+    /**
+     * @brief Pop from whichever core's queue ranks best, if one ranks better than a bound.
+     * Every non-empty queue is ranked under its own lock, so this is meant for rare checks.
+     * @param core_id The core that will run the process.
+     * @param rank Called with a queue; lower ranks go first.
+     * @param bound Only a queue ranking below this is popped from.
+     * @return The process, or nullptr if no queue ranks below bound.
+     */
+    template <typename Rank>
+    std::shared_ptr<Process> popBest(int core_id, Rank rank, int bound)
+    {
+        while (true)
+        {
+            int best_core = 0;
+            int best = bound;
+
+            int seen = seen_cores_.load();
+            for (int i = 1; i <= seen; ++i)
+            {
+                if (queues_[i].size.load() == 0)
+                {
+                    continue;
+                }
+
+                std::lock_guard<std::mutex> lock(queues_[i].mutex);
+                int value = rank(static_cast<const Queue&>(queues_[i].processes));
+                if (value < best)
+                {
+                    best_core = i;
+                    best = value;
+                }
+            }
+
+            if (best_core == 0)
+            {
+                return nullptr;
+            }
+
+            // The queue may have changed since it was ranked; look again if so
+            CoreQueue& queue = queues_[best_core];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.processes.size() > 0 && rank(static_cast<const Queue&>(queue.processes)) == best)
+            {
+                std::shared_ptr<Process> process = queue.processes.pop();
+                updateSize(queue);
+                enter(*process, core_id);
+                return process;
+            }
+        }
+    }
+
+    /**
+     * @brief Look at a core's queue under its lock.
+     * @param core_id The core ID.
+     * @param inspect Called with the queue; its result is returned.
+     * @return Whatever inspect returns.
+     */
+    template <typename Inspect>
+    auto inspect(int core_id, Inspect inspect)
+    {
+        CoreQueue& queue = queues_[core_id];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        return inspect(static_cast<const Queue&>(queue.processes));
+    }
+
+    /**
+     * @brief Check whether any process is waiting, admitted or queued.
+     * @return True if some process is ready.
+     */
+    bool any() const
+    {
+        if (admission_.sizeApprox() > 0)
+        {
+            return true;
+        }
+
+        int seen = seen_cores_.load();
+        for (int i = 1; i <= seen; ++i)
+        {
+            if (queues_[i].size.load() > 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Apply a change to every core's queue in turn, each under its own lock.
+     * @param change Called with each queue; may reorder it but must keep its size.
+     */
+    template <typename Change>
+    void forEachQueue(Change change)
+    {
+        int seen = seen_cores_.load();
+        for (int i = 1; i <= seen; ++i)
+        {
+            std::lock_guard<std::mutex> lock(queues_[i].mutex);
+            change(queues_[i].processes);
+        }
+    }
+
+    /**
+     * @brief Get the decayed length of a core's queue.
+     * @param core_id The core ID.
+     * @return The queue-length load average.
+     */
+    const LoadAverage& getLoad(int core_id) const
+    {
+        return queues_[core_id].length_load;
+    }
+
+private:
+    /**
+     * @struct CoreQueue
+     * @brief Ready processes of one core, padded so cores never share a cache line.
+     */
+    struct alignas(64) CoreQueue
+    {
+        std::mutex mutex;           ///< Protects processes.
+        Queue processes;            ///< Ready processes in policy order.
+        std::atomic<int> size{0};   ///< Size hint readable without the lock.
+        LoadAverage length_load;    ///< Decayed queue length, updated under mutex.
+    };
+
+    /**
+     * @brief Pull half the difference from the longest queue if it is more than
+     * REBALANCE_THRESHOLD processes longer than a core's own.
+     * @param core_id The core taking the processes.
+     */
+    void rebalance(int core_id)
+    {
+        int own = queues_[core_id].size.load();
+        int busiest = 0;
+        int longest = own + REBALANCE_THRESHOLD;
+
+        int seen = seen_cores_.load();
+        for (int i = 1; i <= seen; ++i)
+        {
+            int size = queues_[i].size.load();
+            if (i != core_id && size > longest)
+            {
+                busiest = i;
+                longest = size;
+            }
+        }
+
+        if (busiest == 0)
+        {
+            return;
+        }
+
+        std::vector<std::shared_ptr<Process>> moved;
+        {
+            CoreQueue& queue = queues_[busiest];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            for (int count = (static_cast<int>(queue.processes.size()) - own) / 2; count > 0; --count)
+            {
+                moved.push_back(queue.processes.pop());
+            }
+            updateSize(queue);
+        }
+
+        CoreQueue& queue = queues_[core_id];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (std::shared_ptr<Process>& process : moved)
+        {
+            enter(*process, core_id);
+            queue.processes.push(std::move(process));
+        }
+        updateSize(queue);
+    }
+
+    std::shared_ptr<Process> popFrom(int core_id)
+    {
+        CoreQueue& queue = queues_[core_id];
+        if (queue.size.load() == 0)
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.processes.size() == 0)
+        {
+            return nullptr;
+        }
+
+        std::shared_ptr<Process> process = queue.processes.pop();
+        updateSize(queue);
+        return process;
+    }
+
+    void enter(Process& process, int core_id)
+    {
+        if (enter_)
+        {
+            enter_(process, core_id);
+        }
+    }
+
+    int nextOnlineCore()
+    {
+        return static_cast<int>(next_core_++ % static_cast<unsigned>(online_cores_.load())) + 1;
+    }
+
+    void updateSize(CoreQueue& queue)
+    {
+        queue.size = static_cast<int>(queue.processes.size());
+        queue.length_load.update(cpu_clock_->getCpuClock(), queue.size);
+    }
+
+    int max_cores_;                               ///< Capacity; queues exist for cores 1 to max_cores_.
+    std::atomic<int> online_cores_{1};            ///< Cores 1 to online_cores_ take work.
+    std::atomic<int> seen_cores_{1};              ///< Highest core count ever online; their queues are scanned.
+    bool affinity_;                               ///< Requeue processes on the core they ran on.
+    Clock* cpu_clock_;                            ///< Clock for the queue-length averages.
+    std::unique_ptr<CoreQueue[]> queues_;         ///< Queue of each core, indexed by core ID.
+    MpmcQueue<std::shared_ptr<Process>> admission_; ///< New processes not yet taken by a core.
+    std::atomic<unsigned> next_core_{0};          ///< Round-robin cursor for ring overflow.
+    EnterHook enter_;                             ///< Called when a process is placed on a core, if set.
+};
+
+#endif
@@ -0,0 +1,9 @@
+#include "RoundRobinPolicy.h"
+
+namespace
+{
+    const bool registered = PolicyRegistry::add("rr", [](const PolicyConfig& config)
+    {
+        return std::unique_ptr<SchedulingPolicy>(new RoundRobinPolicy(config));
+    });
+}
@@ -0,0 +1,28 @@
+#ifndef ROUND_ROBIN_POLICY_H
+#define ROUND_ROBIN_POLICY_H
+
+#include "QueuedPolicy.h"
+
+#include <algorithm>
+
+/**
+ * @class RoundRobinPolicy
+ * @brief Round Robin: each process runs for quantum-cycles instructions, then goes to the back
+ * of its core's queue.
+ */
+class RoundRobinPolicy : public QueuedPolicy<RoundRobinPolicy>
+{
+public:
+    using QueuedPolicy::QueuedPolicy;
+
+    /**
+     * @brief Every process gets the configured quantum.
+     * @return The time slice in instructions.
+     */
+    int timeSlice(const Process&, int) const
+    {
+        return std::max(config_.quantum_cycles, 1);
+    }
+};
+
+#endif
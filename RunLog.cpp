@@ -0,0 +1,516 @@
+#include "RunLog.h"
+#include "Clock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+namespace
+{
+    const char* const EVENT_NAMES[] = {"admission", "pick", "keep-running check", "preemption", "finish"};
+    const char* const LOAD_OUTCOMES[] = {"resident", "allocated", "allocated after an eviction", "waiting for memory", "no core"};
+}
+
+/**
+ * @brief Destructor for RunLog. Writes out a recording.
+ */
+RunLog::~RunLog()
+{
+    close();
+}
+
+/**
+ * @brief Start recording. Must be called before any process is admitted.
+ * @param path The log file to write.
+ * @param settings The settings of the run.
+ * @param cpu_clock The clock.
+ * @return False if the clock is not virtual or the file could not be opened.
+ */
+bool RunLog::record(const std::string& path, const std::string& settings, Clock* cpu_clock)
+{
+    if (!cpu_clock->isVirtual())
+    {
+        std::cerr << "Error: Recording a run needs clock-mode \"virtual\"." << std::endl;
+        return false;
+    }
+
+    out_.open(path, std::ios::binary);
+    if (!out_.is_open())
+    {
+        std::cerr << "Error: Unable to open " << path << " for writing." << std::endl;
+        return false;
+    }
+
+    buffer_.append(MAGIC, sizeof(MAGIC));
+    buffer_ += static_cast<char>(VERSION);
+    writeVarint(buffer_, settings.size());
+    buffer_ += settings;
+
+    path_ = path;
+    cpu_clock_ = cpu_clock;
+    mode_ = RECORD;
+    return true;
+}
+
+/**
+ * @brief Load a recording to replay. Must be called before any process is admitted.
+ * @param path The log file to read.
+ * @param settings The settings of this run; they must match the recording's.
+ * @param cpu_clock The clock.
+ * @return False if the clock is not virtual, or the file is unreadable or from other settings.
+ */
+bool RunLog::replay(const std::string& path, const std::string& settings, Clock* cpu_clock)
+{
+    if (!cpu_clock->isVirtual())
+    {
+        std::cerr << "Error: Replaying a run needs clock-mode \"virtual\"." << std::endl;
+        return false;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open())
+    {
+        std::cerr << "Error: Unable to open run log " << path << "." << std::endl;
+        return false;
+    }
+
+    path_ = path;
+    if (!load(in, settings))
+    {
+        return false;
+    }
+
+    cpu_clock_ = cpu_clock;
+    mode_ = REPLAY;
+    if (events_.empty())
+    {
+        release("");
+    }
+    return true;
+}
+
+/**
+ * @brief Read the header and every event of a log.
+ * @param in The log file.
+ * @param settings The settings of this run.
+ * @return False if the file is not a run log or was recorded with other settings.
+ */
+bool RunLog::load(std::ifstream& in, const std::string& settings)
+{
+    char magic[sizeof(MAGIC)] = {};
+    in.read(magic, sizeof(magic));
+    std::uint64_t length = 0;
+    if (!in || !std::equal(magic, magic + sizeof(MAGIC), MAGIC) || in.get() != VERSION || !WorkloadTrace::readVarint(in, length))
+    {
+        std::cerr << "Error: " << path_ << " is not a run log of this version." << std::endl;
+        return false;
+    }
+
+    std::string recorded(static_cast<size_t>(std::min<std::uint64_t>(length, 1 << 20)), '\0');
+    in.read(recorded.data(), static_cast<std::streamsize>(recorded.size()));
+    if (recorded != settings)
+    {
+        std::cerr << "Error: " << path_ << " was recorded with different settings." << std::endl;
+        std::cerr << "  recorded: " << recorded << std::endl;
+        std::cerr << "  current:  " << settings << std::endl;
+        return false;
+    }
+
+    std::uint64_t tick = 0;
+    for (std::uint64_t kind; WorkloadTrace::readVarint(in, kind);)
+    {
+        std::uint64_t delta = 0;
+        std::uint64_t pid = 0;
+        std::uint64_t value = 0;
+        bool complete = WorkloadTrace::readVarint(in, delta) && WorkloadTrace::readVarint(in, pid) && WorkloadTrace::readVarint(in, value);
+
+        WorkloadTrace::Record arrival;
+        if (complete && (kind & 7) == ADMIT)
+        {
+            std::uint64_t memory_kb = 0;
+            std::uint64_t priority = 0;
+            std::uint64_t deadline = 0;
+            complete = WorkloadTrace::readVarint(in, memory_kb) && WorkloadTrace::readVarint(in, priority) && WorkloadTrace::readVarint(in, deadline);
+            arrival.memory_kb = static_cast<size_t>(memory_kb);
+            arrival.priority = static_cast<int>(priority) - 1;
+            arrival.deadline = static_cast<int>(deadline);
+        }
+
+        if (!complete || (kind & 7) > FINISH || (kind >> 3) > 255)
+        {
+            // The recording was cut short; what came before it can still be replayed
+            std::cerr << "Error: " << path_ << " is truncated after " << events_.size() << " events." << std::endl;
+            break;
+        }
+
+        tick += delta;
+        Event event = {static_cast<int>(tick), static_cast<int>(pid), static_cast<int>(value),
+                       static_cast<std::uint8_t>(kind & 7), static_cast<std::uint8_t>(kind >> 3)};
+        if (event.type == ADMIT)
+        {
+            arrival.arrival_tick = event.tick;
+            arrival.instructions = event.value;
+            arrivals_.push_back(arrival);
+        }
+
+        if (event.core >= core_events_.size())
+        {
+            core_events_.resize(event.core + 1);
+        }
+        core_events_[event.core].push_back(static_cast<std::uint32_t>(events_.size()));
+        events_.push_back(event);
+    }
+
+    core_next_.assign(core_events_.size(), 0);
+    return true;
+}
+
+/**
+ * @brief Get the next arrival of the recording, to be admitted with ProcessManager::addProcess.
+ * @param record Receives the arrival; its arrival tick is relative to the first arrival's.
+ * @return False once every arrival has been returned.
+ */
+bool RunLog::nextArrival(WorkloadTrace::Record& record)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (next_arrival_ >= arrivals_.size())
+    {
+        return false;
+    }
+    record = arrivals_[next_arrival_++];
+    return true;
+}
+
+/**
+ * @brief Get the tick at which a core should make its next pick.
+ * @param core_id The core.
+ * @return The tick, NOT_STARTED if the core should park until the first arrival, or -1 if the
+ * core is not held to the recording.
+ */
+int RunLog::nextTick(int core_id)
+{
+    if (!isReplaying())
+    {
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (released_)
+    {
+        return -1;
+    }
+    if (!started_)
+    {
+        // Waiting on the clock now would let it run ahead of the arrivals
+        return NOT_STARTED;
+    }
+
+    size_t core = static_cast<size_t>(core_id);
+    if (core < core_events_.size() && core_next_[core] < core_events_[core].size())
+    {
+        return start_tick_ + events_[core_events_[core][core_next_[core]]].tick;
+    }
+
+    // Nothing left for this core. Once the clock is past the recording, every other decision has
+    // either been replayed or will never be
+    int end = start_tick_ + events_.back().tick + 1;
+    if (cpu_clock_->getCpuClock() < end)
+    {
+        return end;
+    }
+
+    const Event& missing = events_[cursor_];
+    release("the run ended before the " + describe(missing.type, missing.core, missing.pid, missing.value, missing.tick));
+    return -1;
+}
+
+/**
+ * @brief Start a decision. Recording: takes the log lock. Replaying: waits for its turn.
+ * @param core_id The core making the decision, or GENERATOR.
+ */
+void RunLog::begin(int core_id)
+{
+    if (mode_ == RECORD)
+    {
+        mutex_.lock();
+        if (!started_ && core_id == GENERATOR)
+        {
+            start_tick_ = cpu_clock_->getCpuClock();
+            started_ = true;
+        }
+        return;
+    }
+    if (mode_ != REPLAY || released_.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t core = static_cast<size_t>(core_id);
+    if (core >= core_events_.size() || core_next_[core] >= core_events_[core].size())
+    {
+        release("core " + std::to_string(core_id) + " made more decisions than were recorded");
+        return;
+    }
+
+    // Earlier decisions belong to the same tick or to threads the clock is waiting for, so they
+    // come quickly; a long wait means the run took another path
+    size_t index = core_events_[core][core_next_[core]];
+    size_t seen = cursor_;
+    auto progress = std::chrono::steady_clock::now();
+    while (!released_ && cursor_ != index)
+    {
+        turn_.wait_for(lock, std::chrono::milliseconds(100));
+        if (cursor_ != seen)
+        {
+            seen = cursor_;
+            progress = std::chrono::steady_clock::now();
+        }
+        else if (!released_ && std::chrono::steady_clock::now() - progress >= std::chrono::seconds(STALL_SECONDS))
+        {
+            const Event& waiting = events_[cursor_];
+            release("it stalled waiting for the " + describe(waiting.type, waiting.core, waiting.pid, waiting.value, waiting.tick));
+        }
+    }
+
+    if (!started_ && core_id == GENERATOR)
+    {
+        start_tick_ = cpu_clock_->getCpuClock();
+        started_ = true;
+    }
+}
+
+/**
+ * @brief Finish a decision started with begin(), logging it or checking it against the recording.
+ * @param core_id The core that made the decision.
+ * @param type The kind of decision.
+ * @param pid The process it concerned.
+ * @param value The event-specific value, see EventType.
+ * @param arrival For ADMIT, the instructions, memory, priority and deadline of the process.
+ */
+void RunLog::end(int core_id, EventType type, int pid, int value, const WorkloadTrace::Record* arrival)
+{
+    if (mode_ == RECORD)
+    {
+        if (!closed_)
+        {
+            int tick = cpu_clock_->getCpuClock() - start_tick_;
+            writeVarint(buffer_, static_cast<std::uint64_t>(type) | static_cast<std::uint64_t>(core_id) << 3);
+            writeVarint(buffer_, static_cast<std::uint64_t>(tick - last_tick_));
+            writeVarint(buffer_, static_cast<std::uint64_t>(pid));
+            writeVarint(buffer_, static_cast<std::uint64_t>(value));
+            if (type == ADMIT)
+            {
+                writeVarint(buffer_, arrival->memory_kb);
+                writeVarint(buffer_, static_cast<std::uint64_t>(arrival->priority + 1));
+                writeVarint(buffer_, static_cast<std::uint64_t>(arrival->deadline));
+            }
+            last_tick_ = tick;
+            recorded_++;
+
+            if (buffer_.size() >= FLUSH_BYTES)
+            {
+                flush();
+            }
+        }
+        mutex_.unlock();
+        return;
+    }
+    if (mode_ != REPLAY || released_.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (released_)
+    {
+        return;
+    }
+
+    size_t core = static_cast<size_t>(core_id);
+    const Event& expected = events_[cursor_];
+    int tick = cpu_clock_->getCpuClock() - start_tick_;
+    bool match = expected.core == core && expected.type == type && expected.pid == pid && expected.value == value && expected.tick == tick;
+    if (match && type == ADMIT)
+    {
+        const WorkloadTrace::Record& recorded = arrivals_[admitted_++];
+        match = recorded.memory_kb == arrival->memory_kb && recorded.priority == arrival->priority && recorded.deadline == arrival->deadline;
+    }
+
+    if (!match)
+    {
+        release("expected the " + describe(expected.type, expected.core, expected.pid, expected.value, expected.tick) +
+                ", got the " + describe(type, core_id, pid, value, tick));
+        return;
+    }
+
+    core_next_[core]++;
+    cursor_++;
+    if (cursor_ == events_.size())
+    {
+        release("");
+    }
+    turn_.notify_all();
+}
+
+/**
+ * @brief Finish a decision started with begin() that turned out to be nothing, e.g. an empty pick.
+ * @param core_id The core.
+ */
+void RunLog::cancel(int core_id)
+{
+    if (mode_ == RECORD)
+    {
+        mutex_.unlock();
+        return;
+    }
+    if (mode_ != REPLAY || released_.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!released_)
+    {
+        const Event& expected = events_[cursor_];
+        release("expected the " + describe(expected.type, expected.core, expected.pid, expected.value, expected.tick) +
+                ", but core " + std::to_string(core_id) + " found nothing to run");
+    }
+}
+
+/**
+ * @brief Stop holding the run to the recording, e.g. because arrivals were stopped.
+ */
+void RunLog::stopReplay()
+{
+    if (mode_ != REPLAY)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!released_)
+    {
+        outcome_ = "stopped";
+        released_.store(true, std::memory_order_release);
+        turn_.notify_all();
+    }
+}
+
+/**
+ * @brief Release every thread waiting for its turn and let the run carry on unchecked.
+ * Called with mutex_ held.
+ * @param reason Why the replay diverged, or empty if it completed.
+ */
+void RunLog::release(const std::string& reason)
+{
+    if (!reason.empty())
+    {
+        std::cerr << "Error: Replay of " << path_ << " diverged at decision " << cursor_ + 1 << " of " << events_.size()
+                  << ": " << reason << "." << std::endl;
+    }
+    outcome_ = reason;
+    released_.store(true, std::memory_order_release);
+    turn_.notify_all();
+}
+
+/**
+ * @brief Describe a decision for an error message.
+ * @return E.g. "pick of process 12 on core 3 at tick 450 (allocated)".
+ */
+std::string RunLog::describe(int type, int core, int pid, int value, int tick) const
+{
+    std::ostringstream text;
+    text << EVENT_NAMES[type] << " of process " << pid;
+    if (type != ADMIT)
+    {
+        text << " on core " << core;
+    }
+    text << " at tick " << tick << " (";
+
+    if (type == PICK)
+    {
+        text << (value >= 0 && value <= NO_CORE ? LOAD_OUTCOMES[value] : "unknown outcome");
+    }
+    else if (type == KEEP)
+    {
+        text << (value ? "kept the core" : "gave up the core");
+    }
+    else
+    {
+        text << value << " instructions";
+    }
+    text << ")";
+    return text.str();
+}
+
+/**
+ * @brief Write out a recording and stop logging. Decisions still in progress are dropped.
+ */
+void RunLog::close()
+{
+    if (mode_ != RECORD)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!closed_)
+    {
+        flush();
+        out_.close();
+        closed_ = true;
+    }
+}
+
+/**
+ * @brief Print what was recorded, or how far the replay matched.
+ * @param out Output stream to print to.
+ */
+void RunLog::report(std::ostream& out)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (mode_ == RECORD)
+    {
+        out << "Recorded " << recorded_ << " decisions (" << bytes_ + static_cast<long long>(buffer_.size()) << " bytes) to " << path_ << std::endl;
+    }
+    else if (mode_ == REPLAY)
+    {
+        out << "Replay of " << path_ << ": " << cursor_ << " of " << events_.size() << " decisions matched";
+        if (!released_)
+        {
+            out << " so far";
+        }
+        else if (!outcome_.empty())
+        {
+            out << "; " << (outcome_ == "stopped" ? "stopped" : "diverged") << " after that";
+        }
+        out << std::endl;
+    }
+}
+
+/**
+ * @brief Write the buffered events to the log file. Called with mutex_ held.
+ */
+void RunLog::flush()
+{
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    out_.flush();
+    bytes_ += static_cast<long long>(buffer_.size());
+    buffer_.clear();
+}
+
+/**
+ * @brief Append an unsigned LEB128 varint: seven bits per byte, low bits first.
+ * @param out The buffer.
+ * @param value The number.
+ */
+void RunLog::writeVarint(std::string& out, std::uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
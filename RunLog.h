@@ -0,0 +1,227 @@
+#ifndef RUN_LOG_H
+#define RUN_LOG_H
+
+#include "WorkloadTrace.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Clock;
+
+/**
+ * @class RunLog
+ * @brief Records every scheduling decision and allocation outcome of a run, or replays a recording.
+ *
+ * A decision is one of: a process admitted, a core picking a process and loading it into memory,
+ * a keep-running check at the end of a time slice, and a process preempted or finished. The
+ * scheduler brackets each with begin() and end() on the thread that makes it. Ticks count from the
+ * first admission.
+ *
+ * While recording, begin() takes a lock, so the decisions of all cores happen one at a time and
+ * the log holds the order they happened in. While replaying, begin() blocks until every earlier
+ * decision of the recording has been replayed, so each decision sees the same policy and memory
+ * state as it did in the recording, whatever order the host threads run in. Cores park until the
+ * first arrival, then wait on the clock for the tick of their next pick instead of parking, and
+ * arrivals are fed in from the log (see nextArrival). end() compares each decision, with its tick, against the recording. The
+ * first mismatch is reported, and the rest of the run carries on unchecked.
+ *
+ * Both need the virtual clock. The log file starts with the magic "CSRL", a version byte and the
+ * settings the run depends on (see EmulatorConfig::describeRun); a replay with different settings
+ * is refused. Each event is then a few unsigned LEB128 varints: type and core, ticks since the
+ * previous event, process ID and an event-specific value, plus memory, priority and deadline for
+ * arrivals. A replay reads the whole log into memory, 16 bytes per event.
+ *
+ * Hot-plugging cores during a recorded run is not replayed.
+ */
+class RunLog
+{
+public:
+    static constexpr int GENERATOR = 0;   ///< Core ID under which admissions are logged.
+    static constexpr int NOT_STARTED = -2; ///< nextTick() before the first arrival of a replay.
+
+    /**
+     * @enum EventType
+     * @brief The kind of decision.
+     */
+    enum EventType : std::uint8_t
+    {
+        ADMIT,    ///< A process was admitted; the value is its instruction count.
+        PICK,     ///< A core picked a process; the value is a LoadOutcome.
+        KEEP,     ///< A time slice ended; the value is 1 if the process kept the core.
+        PREEMPT,  ///< A process left the core unfinished; the value is the instructions it ran.
+        FINISH    ///< A process ran its last instruction; the value is the instructions it ran.
+    };
+
+    /**
+     * @enum LoadOutcome
+     * @brief What happened when a picked process was loaded into memory.
+     */
+    enum LoadOutcome
+    {
+        RESIDENT,     ///< It was already in memory.
+        ALLOCATED,    ///< It fit in free memory.
+        EVICTED,      ///< It fit after the oldest resident process was evicted.
+        MEMORY_WAIT,  ///< It did not fit and went to the memory-wait queue.
+        NO_CORE       ///< No core could be counted for it; it went back to the policy.
+    };
+
+    /**
+     * @brief Destructor for RunLog. Writes out a recording.
+     */
+    ~RunLog();
+
+    /**
+     * @brief Start recording. Must be called before any process is admitted.
+     * @param path The log file to write.
+     * @param settings The settings of the run.
+     * @param cpu_clock The clock.
+     * @return False if the clock is not virtual or the file could not be opened.
+     */
+    bool record(const std::string& path, const std::string& settings, Clock* cpu_clock);
+
+    /**
+     * @brief Load a recording to replay. Must be called before any process is admitted.
+     * @param path The log file to read.
+     * @param settings The settings of this run; they must match the recording's.
+     * @param cpu_clock The clock.
+     * @return False if the clock is not virtual, or the file is unreadable or from other settings.
+     */
+    bool replay(const std::string& path, const std::string& settings, Clock* cpu_clock);
+
+    /**
+     * @brief Check whether decisions are being recorded.
+     * @return True while recording.
+     */
+    bool isRecording() const
+    {
+        return mode_ == RECORD;
+    }
+
+    /**
+     * @brief Check whether decisions still follow the recording.
+     * @return False once the replay completed, diverged or was stopped, or if not replaying.
+     */
+    bool isReplaying() const
+    {
+        return mode_ == REPLAY && !released_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Get the next arrival of the recording, to be admitted with ProcessManager::addProcess.
+     * @param record Receives the arrival; its arrival tick is relative to the first arrival's.
+     * @return False once every arrival has been returned.
+     */
+    bool nextArrival(WorkloadTrace::Record& record);
+
+    /**
+     * @brief Get the tick at which a core should make its next pick.
+     * @param core_id The core.
+     * @return The tick, NOT_STARTED if the core should park until the first arrival, or -1 if the
+     * core is not held to the recording.
+     */
+    int nextTick(int core_id);
+
+    /**
+     * @brief Start a decision. Recording: takes the log lock. Replaying: waits for its turn.
+     * @param core_id The core making the decision, or GENERATOR.
+     */
+    void begin(int core_id);
+
+    /**
+     * @brief Finish a decision started with begin(), logging it or checking it against the recording.
+     * @param core_id The core that made the decision.
+     * @param type The kind of decision.
+     * @param pid The process it concerned.
+     * @param value The event-specific value, see EventType.
+     * @param arrival For ADMIT, the instructions, memory, priority and deadline of the process.
+     */
+    void end(int core_id, EventType type, int pid, int value, const WorkloadTrace::Record* arrival = nullptr);
+
+    /**
+     * @brief Finish a decision started with begin() that turned out to be nothing, e.g. an empty pick.
+     * @param core_id The core.
+     */
+    void cancel(int core_id);
+
+    /**
+     * @brief Stop holding the run to the recording, e.g. because arrivals were stopped.
+     */
+    void stopReplay();
+
+    /**
+     * @brief Write out a recording and stop logging. Decisions still in progress are dropped.
+     */
+    void close();
+
+    /**
+     * @brief Print what was recorded, or how far the replay matched.
+     * @param out Output stream to print to.
+     */
+    void report(std::ostream& out);
+
+private:
+    enum Mode
+    {
+        OFF,
+        RECORD,
+        REPLAY
+    };
+
+    /**
+     * @struct Event
+     * @brief One decision as read back from a log.
+     */
+    struct Event
+    {
+        int tick;                 ///< Ticks after the start.
+        int pid;                  ///< Process ID.
+        int value;                ///< Event-specific value.
+        std::uint8_t type;        ///< EventType.
+        std::uint8_t core;        ///< Core ID, or GENERATOR.
+    };
+
+    static constexpr char MAGIC[4] = {'C', 'S', 'R', 'L'};
+    static constexpr std::uint8_t VERSION = 1;
+    static constexpr int STALL_SECONDS = 10;   ///< Host seconds without progress before a replay gives up.
+    static constexpr size_t FLUSH_BYTES = 1 << 16;
+
+    bool load(std::ifstream& in, const std::string& settings);
+    void release(const std::string& reason);
+    std::string describe(int type, int core, int pid, int value, int tick) const;
+    void flush();
+
+    static void writeVarint(std::string& out, std::uint64_t value);
+
+    Mode mode_ = OFF;                       ///< Set once, before any decision.
+    std::string path_;                      ///< The log file.
+    Clock* cpu_clock_ = nullptr;            ///< The simulated clock.
+    int start_tick_ = 0;                    ///< Clock tick of the first admission.
+    bool started_ = false;                  ///< Whether the first admission has begun.
+    std::mutex mutex_;                      ///< Recording: held through a decision. Replay: guards cursor_.
+
+    std::ofstream out_;                     ///< Recording: the log file.
+    std::string buffer_;                    ///< Recording: encoded events not yet written.
+    int last_tick_ = 0;                     ///< Recording: tick of the last event.
+    long long recorded_ = 0;                ///< Recording: events logged.
+    long long bytes_ = 0;                   ///< Recording: bytes written.
+    bool closed_ = false;                   ///< Recording: close() was called.
+
+    std::vector<Event> events_;             ///< Replay: every event, in order.
+    std::vector<WorkloadTrace::Record> arrivals_; ///< Replay: memory, priority and deadline of each ADMIT.
+    std::vector<std::vector<std::uint32_t>> core_events_; ///< Replay: indexes of each core's events.
+    std::vector<size_t> core_next_;         ///< Replay: position in core_events_ of each core's next event.
+    size_t next_arrival_ = 0;               ///< Replay: next arrival for nextArrival().
+    size_t admitted_ = 0;                   ///< Replay: ADMIT events replayed, to match up arrivals_.
+    size_t cursor_ = 0;                     ///< Replay: index of the next event to replay.
+    std::condition_variable turn_;          ///< Replay: signalled whenever cursor_ moves.
+    std::atomic<bool> released_{false};     ///< Replay: no longer held to the recording.
+    std::string outcome_;                   ///< Replay: why it was released.
+};
+
+#endif
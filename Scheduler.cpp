@@ -1,397 +1,671 @@
 #include "Scheduler.h"
 #include "Process.h"
 #include "CoreStateManager.h"
+#include "CpuAffinity.h"
 #include "Clock.h"
 #include "FlatMemoryAllocator.h"
 
 #include <iostream>
 #include <chrono>
 #include <iomanip>
+#include <algorithm>
+
+static_assert(Tracer::MAX_RINGS > Scheduler::MAX_CORES, "every core needs a trace ring");
 
 /**
  * @brief Constructor for Scheduler.
  */
 Scheduler::Scheduler(std::string scheduler_algo, int delays_per_exec, int n_cpu, int quantum_cycle, Clock* cpu_clock, IMemoryAllocator* memory_allocator)
     : is_running(false), active_threads_(0), ready_threads(0), scheduler_algorithm(scheduler_algo), delay_per_execution(delays_per_exec),
-      cpu_count(n_cpu), quantum_cycle(quantum_cycle), cpu_clock(cpu_clock), memory_allocator_(memory_allocator)
+      cpu_count(std::clamp(n_cpu, 1, MAX_CORES)), quantum_cycle(quantum_cycle), worker_threads_(MAX_CORES + 1),
+      core_online_(new std::atomic<bool>[MAX_CORES + 1]), core_alive_(MAX_CORES + 1, false), cpu_clock(cpu_clock),
+      memory_allocator_(memory_allocator), core_load_(new CoreLoad[MAX_CORES + 1])
 {
+    for (int i = 0; i <= MAX_CORES; ++i)
+    {
+        core_online_[i] = false;
+    }
+    createPolicy();
 }
 
+Scheduler::~Scheduler() = default;
+
 /**
  * @brief Adds a process to the scheduling queue.
  * @param process Shared pointer to the process.
  */
 void Scheduler::addProcess(std::shared_ptr<Process> process)
 {
-    if (!memory_log_)
+    cpu_clock->addWork();
+
+    int now = cpu_clock->getCpuClock();
+    process->setArrivalTick(now);
+    process->setReadySince(now);
+    policy_->admit(process);
+    wakeIdleCore();
+}
+
+/**
+ * @brief Creates the policy named by scheduler_algorithm, falling back to FCFS.
+ */
+void Scheduler::createPolicy()
+{
+    PolicyConfig config = policy_config_;
+    config.num_cpus = cpu_count;
+    config.max_cpus = MAX_CORES;
+    config.quantum_cycles = quantum_cycle;
+    config.cpu_clock = cpu_clock;
+    config.ticks_per_instruction = std::max(delay_per_execution, 1);
+    config.context_switch_ticks = context_switch_ticks_;
+    config.migration_cost_ticks = migration_cost_ticks_;
+
+    policy_ = PolicyRegistry::create(scheduler_algorithm, config);
+    if (!policy_)
+    {
+        std::cerr << "Error: Unknown scheduler \"" << scheduler_algorithm << "\". Available:";
+        for (const std::string& name : PolicyRegistry::names())
+        {
+            std::cerr << " " << name;
+        }
+        std::cerr << ". Using fcfs." << std::endl;
+
+        scheduler_algorithm = "fcfs";
+        policy_ = PolicyRegistry::create(scheduler_algorithm, config);
+    }
+}
+
+/**
+ * @brief Parks the calling core on the clock until a process is queued, the core goes offline
+ * or the scheduler stops.
+ * @param core_id The calling core.
+ */
+void Scheduler::waitForWork(int core_id)
+{
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    idle_waiters_++;
+
+    // Announce first, then look: a process queued after this point will see us waiting
+    if (policy_->hasWork() || !is_running || !core_online_[core_id])
     {
-        startMemoryLog();
+        idle_waiters_--;
+        return;
     }
 
-    std::unique_lock<std::mutex> lock(queue_mutex_);
-    process_queue_.push(process);
-    queue_condition_.notify_one();
+    cpu_clock->suspendParticipant();
+
+    idle_condition_.wait(lock, [this, core_id]
+    {
+        return idle_wakeups_ > 0 || !is_running || !core_online_[core_id];
+    });
+
+    if (idle_wakeups_ > 0)
+    {
+        // wakeIdleCore already resumed this core on the clock
+        idle_wakeups_--;
+    }
+    else
+    {
+        idle_waiters_--;
+        cpu_clock->resumeParticipant();
+    }
 }
 
-void Scheduler::setAlgorithm(const std::string& algorithm)
+/**
+ * @brief Hands a wake-up to one idle core, if any, after a process was queued.
+ */
+void Scheduler::wakeIdleCore()
 {
-    scheduler_algorithm = algorithm;
+    // Idle cores announce themselves before their final check of the queues, and we check for
+    // them after publishing the process, so either they see it or we see them
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (idle_waiters_.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        if (idle_waiters_.load() > 0)
+        {
+            // Resume the idle core on the clock before it wakes up, so no tick can pass without it
+            idle_waiters_--;
+            idle_wakeups_++;
+            cpu_clock->resumeParticipant();
+            idle_condition_.notify_one();
+        }
+    }
 }
 
-void Scheduler::setNumCPUs(int num)
+int Scheduler::getNumCPUs() const
 {
-    cpu_count = num;
-    CoreStateManager::getInstance().initialize(cpu_count);
+    return cpu_count;
 }
 
-void Scheduler::setDelays(int delay)
+int Scheduler::getCoreSlots() const
 {
-    delay_per_execution = delay;
+    return core_slots_;
 }
 
-void Scheduler::setCPUClock(Clock* clock)
+bool Scheduler::isCoreOnline(int core_id) const
 {
-    cpu_clock = clock;
+    return core_id >= 1 && core_id <= MAX_CORES && core_online_[core_id];
 }
 
-void Scheduler::setQuantumCycle(int quantum_cycle)
+const CoreLoad& Scheduler::getCoreLoad(int core_id) const
 {
-    quantum_cycle = quantum_cycle;
+    return core_load_[core_id];
+}
+
+const LoadAverage& Scheduler::getRunQueueLoad(int core_id) const
+{
+    return policy_->getQueueLoad(core_id);
 }
 
 /**
- * @brief Starts the scheduler and creates worker threads for each core.
+ * @brief Gets the mean turnaround time of finished processes.
+ * @return Mean ticks from admission to completion, or 0 if none finished yet.
  */
-void Scheduler::start()
+double Scheduler::getMeanTurnaround() const
 {
-    is_running = true;
-    for (int i = 1; i <= cpu_count; ++i)
+    return metrics_.getMeanTurnaround();
+}
+
+/**
+ * @brief Gets the number of processes that ran to completion.
+ * @return The count.
+ */
+long long Scheduler::getFinishedProcesses() const
+{
+    return metrics_.getFinished();
+}
+
+/**
+ * @brief Gets the wait, response and turnaround distributions of finished processes.
+ * @return Reference to the metrics.
+ */
+const SchedulingMetrics& Scheduler::getMetrics() const
+{
+    return metrics_;
+}
+
+const SchedulingPolicy& Scheduler::getPolicy() const
+{
+    return *policy_;
+}
+
+/**
+ * @brief Marks a core busy or idle on the clock and in its load counters.
+ * @param core_id The core ID.
+ * @param busy True if the core started running a process.
+ */
+void Scheduler::setCoreBusy(int core_id, bool busy)
+{
+    if (busy)
     {
-        worker_threads_.emplace_back(&Scheduler::run, this, i);
+        cpu_clock->markCoreActive();
     }
-
+    else
     {
-        std::unique_lock<std::mutex> lock(start_mutex_);
-        start_condition_.wait(lock, [this]
-        {
-            return ready_threads == cpu_count;
-        });
+        cpu_clock->markCoreIdle();
     }
+
+    core_load_[core_id].setBusy(cpu_clock->getCpuClock(), busy);
 }
 
 /**
- * @brief Starts a thread to log memory usage periodically.
+ * @brief Charges a context switch to a core, keeping it busy for the configured number of ticks.
+ * @param core_id The core ID.
+ * @param tick_slot The clock tick slot owned by this core.
+ *
+ * The cost is paid in simulated ticks, so the host thread only waits as long as the clock takes
+ * to get there (no time at all in virtual mode).
  */
-void Scheduler::startMemoryLog()
+void Scheduler::chargeContextSwitch(int core_id, int tick_slot)
 {
-    memory_log_ = true;
-    memory_logging_thread_ = std::thread([this]()
+    core_load_[core_id].addContextSwitch(context_switch_ticks_);
+
+    if (context_switch_ticks_ > 0)
     {
-        std::unique_lock<std::mutex> lock(cpu_clock->getMutex());
+        cpu_clock->waitUntil(tick_slot, cpu_clock->getCpuClock() + context_switch_ticks_);
+    }
+}
 
-        while (is_running)
-        {
-            // Wait for CPU clock tick increment
-            cpu_clock->getCondition().wait(lock);
+/**
+ * @brief Evicts the oldest resident process that is not running, if there is one.
+ * @param process The process that needs memory.
+ * @return True if a process was evicted.
+ */
+bool Scheduler::evictFor(std::shared_ptr<Process> process)
+{
+    // Running processes are never picked, so this does not wait for other cores
+    return memory_allocator_->deallocateOldest(process->getMemoryRequired());
+}
 
-            bool any_core_active = false;
+void Scheduler::setAlgorithm(const std::string& algorithm)
+{
+    scheduler_algorithm = algorithm;
+    createPolicy();
+}
 
-            // Check if any core is active
-            for (int i = 1; i <= cpu_count; ++i)
-            {
-                if (CoreStateManager::getInstance().getCoreState(i))
-                {
-                    any_core_active = true;
-                    break;
-                }
-            }
+void Scheduler::setNumCPUs(int num)
+{
+    cpu_count = std::clamp(num, 1, MAX_CORES);
+    createPolicy();
 
-            // Increment active CPU count if at least one core is active
-            if (any_core_active)
-            {
-                cpu_clock->incrementActiveCpuNum();
-            }
-        }
-    });
+    // Sized for every core once, so hot-plugging never resizes what screen -ls is reading
+    CoreStateManager::getInstance().initialize(MAX_CORES);
 }
 
 /**
- * @brief Stops the scheduler and joins all worker threads.
+ * @brief Grows or shrinks the number of online cores while the scheduler runs.
+ * @param num The new number of cores, from 1 to MAX_CORES.
+ *
+ * New cores get a worker thread straight away and steal from the busiest queue on their first
+ * pick. Cores being removed notice at their next instruction or while parked, requeue their
+ * current process, and drain their queue to the remaining cores before their thread exits.
  */
-void Scheduler::stop()
+void Scheduler::setOnlineCores(int num)
 {
-    is_running = false;
-    queue_condition_.notify_all();
+    num = std::clamp(num, 1, MAX_CORES);
+
+    std::lock_guard<std::mutex> lock(hotplug_mutex_);
+    int old = cpu_count;
+    cpu_count = num;
+    policy_->setOnlineCores(num);
 
-    if (memory_logging_thread_.joinable())
+    if (!is_running)
     {
-        memory_logging_thread_.join();
+        return;
     }
 
-    for (auto& thread : worker_threads_)
+    for (int i = old + 1; i <= num; ++i)
+    {
+        startCore(i);
+    }
+
+    if (num < old)
     {
-        if (thread.joinable())
         {
-            thread.join();
+            std::lock_guard<std::mutex> idle_lock(idle_mutex_);
+            for (int i = num + 1; i <= old; ++i)
+            {
+                core_online_[i] = false;
+            }
         }
+
+        // Parked cores have to wake up to leave
+        idle_condition_.notify_all();
     }
 }
 
+void Scheduler::setDelays(int delay)
+{
+    delay_per_execution = delay;
+    createPolicy();
+}
+
+void Scheduler::setCPUClock(Clock* clock)
+{
+    cpu_clock = clock;
+}
+
+void Scheduler::setQuantumCycle(int quantum_cycle)
+{
+    this->quantum_cycle = quantum_cycle;
+    createPolicy();
+}
+
+void Scheduler::setPolicyConfig(const PolicyConfig& config)
+{
+    policy_config_ = config;
+    createPolicy();
+}
+
+void Scheduler::setContextSwitchTicks(int ticks)
+{
+    context_switch_ticks_ = std::max(ticks, 0);
+    createPolicy();
+}
+
+void Scheduler::setMigrationCostTicks(int ticks)
+{
+    migration_cost_ticks_ = std::max(ticks, 0);
+    createPolicy();
+}
+
+void Scheduler::setRunLog(RunLog* run_log)
+{
+    run_log_ = run_log;
+}
+
 /**
- * @brief Main run loop for each worker thread.
- * @param core_id The core ID where the process will run.
+ * @brief Counts a core as running a process.
+ * @return False if every core is already counted.
  */
-void Scheduler::run(int core_id)
+bool Scheduler::acquireCore()
 {
-    {
-        std::lock_guard<std::mutex> lock(start_mutex_);
-        ready_threads++;
-        if (ready_threads == cpu_count)
-        {
-            start_condition_.notify_one();
-        }
-    }
+    std::lock_guard<std::mutex> lock(active_threads_mutex_);
+    active_threads_++;
 
-    if (scheduler_algorithm == "rr")
+    // Cores on their way offline may still finish a pick, so count every core that has a thread
+    if (active_threads_ > core_slots_)
     {
-        scheduleRR(core_id);
+        std::cerr << "Error: Exceeded CPU limit!" << std::endl;
+        active_threads_--;
+        return false;
     }
-    else if (scheduler_algorithm == "fcfs")
+    return true;
+}
+
+/**
+ * @brief Counts a core as no longer running a process.
+ * @param core_id The core ID.
+ */
+void Scheduler::releaseCore(int core_id)
+{
     {
-        scheduleFCFS(core_id);
+        std::lock_guard<std::mutex> lock(active_threads_mutex_);
+        active_threads_--;
     }
+    CoreStateManager::getInstance().setCoreState(core_id, false, "");
 }
 
 /**
- * @brief Implements First Come First Serve (FCFS) scheduling.
- * @param core_id The core ID where the process will run.
+ * @brief Makes sure a process has memory, evicting the oldest process once if it does not fit.
+ * A process that still does not fit is parked in the memory-wait queue. The process is marked
+ * running before anything else, so eviction skips it while it loads.
+ * @param process The process about to run.
+ * @param core_id The core that picked it.
+ * @return How it was loaded; the process can run unless this is RunLog::MEMORY_WAIT.
  */
-void Scheduler::scheduleFCFS(int core_id)
+RunLog::LoadOutcome Scheduler::loadProcess(const std::shared_ptr<Process>& process, int core_id)
 {
-    while (is_running)
+    // Marked running first, so another core's eviction can no longer pick it
+    if (memory_allocator_->claim(*process))
+    {
+        return RunLog::RESIDENT;
+    }
+
+    void* memory = memory_allocator_->allocate(process);
+    bool evicted = false;
+    if (!memory)
     {
-        std::shared_ptr<Process> process;
+        TRACE_EVENT(core_id, Tracer::ALLOC_FAIL, static_cast<int>(process->getPID()), static_cast<int>(process->getMemoryRequired()), cpu_clock->getCpuClock());
 
+        evicted = evictFor(process);
+        if (evicted)
         {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            queue_condition_.wait(lock, [this]
-            {
-                return !process_queue_.empty() || !is_running;
-            });
+            TRACE_EVENT(core_id, Tracer::EVICT, static_cast<int>(process->getPID()), 0, cpu_clock->getCpuClock());
+        }
+        memory = memory_allocator_->allocate(process);
+    }
 
-            if (!is_running)
-            {
-                break;
-            }
+    bool other_waiters = false;
+    if (!memory)
+    {
+        std::lock_guard<std::mutex> lock(memory_wait_mutex_);
 
-            process = process_queue_.front();
-            process_queue_.pop();
+        // Memory freed before we took the lock found no waiter to wake, so look once more
+        memory = memory_allocator_->allocate(process);
+        if (!memory)
+        {
+            // The time in the ready queue until now was waiting too; memory stall counts from here
+            int now = cpu_clock->getCpuClock();
+            process->addWaitTicks(now - process->getReadySince());
+            other_waiters = !memory_wait_.empty();
+            process->setState(Process::ProcessState::WAITING);
+            memory_wait_.emplace_back(process, now);
+            TRACE_EVENT(core_id, Tracer::MEMORY_WAIT, static_cast<int>(process->getPID()), 0, now);
         }
+    }
 
-        if (process)
+    if (!memory)
+    {
+        // The eviction freed memory this process could not use; an earlier waiter may fit
+        if (evicted && other_waiters)
         {
-            {
-                std::lock_guard<std::mutex> lock(active_threads_mutex_);
-                active_threads_++;
-                if (active_threads_ > cpu_count)
-                {
-                    std::cerr << "Error: Exceeded CPU limit!" << std::endl;
-                    active_threads_--;
-                    continue;
-                }
-            }
+            wakeMemoryWaiter(core_id);
+        }
+        return RunLog::MEMORY_WAIT;
+    }
 
-            // Allocate memory for the process
-            void* memory = memory_allocator_->allocate(process);
+    process->setMemory(memory);
+    return evicted ? RunLog::EVICTED : RunLog::ALLOCATED;
+}
 
-            // If allocation was successful, set allocation time and memory pointer
-            if (memory)
-            {
-                process->setAllocTime();
-                process->setMemory(memory);
-            }
+/**
+ * @brief Moves the longest-waiting process, if any, from the memory-wait queue back to the policy.
+ * Called whenever memory is freed.
+ * @param core_id The core that freed the memory; its queue takes the process.
+ */
+void Scheduler::wakeMemoryWaiter(int core_id)
+{
+    std::shared_ptr<Process> process;
+    int since;
+    {
+        std::lock_guard<std::mutex> lock(memory_wait_mutex_);
+        if (memory_wait_.empty())
+        {
+            return;
+        }
+        std::tie(process, since) = memory_wait_.front();
+        memory_wait_.pop_front();
+    }
 
-            // If no free memory, deallocate the oldest and allocate again
-            if (!memory)
-            {
-                do
-                {
-                    memory_allocator_->deallocateOldest(process->getMemoryRequired());
-                    memory = memory_allocator_->allocate(process);
-                    if (memory)
-                    {
-                        process->setAllocTime();
-                        process->setMemory(memory);
-                    }
-                }
-                while (!memory);
-            }
+    int now = cpu_clock->getCpuClock();
+    int stall = std::max(now - since, 0);
+    process->addMemoryStall(stall);
+    memory_stall_ticks_ += stall;
+    TRACE_EVENT(core_id, Tracer::MEMORY_WAKE, static_cast<int>(process->getPID()), stall, now);
 
-            process->setState(Process::ProcessState::RUNNING);
-            process->setCPUCoreID(core_id);
-            CoreStateManager::getInstance().setCoreState(core_id, true, process->getName());
+    process->setState(Process::ProcessState::READY);
+    process->setReadySince(now);
+    policy_->resume(process, core_id);
+    wakeIdleCore();
+}
 
-            int last_clock = cpu_clock->getCpuClock();
-            bool first_command_executed = false;
-            int cycle_counter = 0;
+/**
+ * @brief Gets the number of processes waiting for memory.
+ * @return The length of the memory-wait queue.
+ */
+size_t Scheduler::getMemoryWaiting()
+{
+    std::lock_guard<std::mutex> lock(memory_wait_mutex_);
+    return memory_wait_.size();
+}
 
-            while (process->getCommandCounter() < process->getLinesOfCode())
-            {
-                {
-                    // Wait for the next CPU cycle
-                    std::unique_lock<std::mutex> lock(cpu_clock->getMutex());
-                    cpu_clock->getCondition().wait(lock, [&]
-                    {
-                        return cpu_clock->getCpuClock() > last_clock;
-                    });
-                    last_clock = cpu_clock->getCpuClock();
-                }
-
-                if (!first_command_executed || (++cycle_counter >= delay_per_execution))
-                {
-                    process->executeCurrentCommand();
-                    first_command_executed = true;
-                    cycle_counter = 0;
-                }
-            }
+/**
+ * @brief Gets the ticks processes have spent waiting for memory.
+ * @return Memory stall ticks of every process that left the memory-wait queue.
+ */
+long long Scheduler::getMemoryStallTicks() const
+{
+    return memory_stall_ticks_.load();
+}
 
-            process->setState(Process::ProcessState::FINISHED);
+/**
+ * @brief Puts a process on a core, charging the cold cache if it last ran elsewhere.
+ * @param process The process.
+ * @param core_id The core ID.
+ * @param tick_slot The clock tick slot owned by this core.
+ */
+void Scheduler::beginRun(const std::shared_ptr<Process>& process, int core_id, int tick_slot)
+{
+    int last_core = process->getCPUCoreID();
+    int now = cpu_clock->getCpuClock();
 
-            {
-                memory_allocator_->deallocate(process);
-                std::lock_guard<std::mutex> lock(active_threads_mutex_);
-                active_threads_--;
-            }
+    process->addWaitTicks(now - process->getReadySince());
+    if (process->getFirstRunTick() < 0)
+    {
+        process->setFirstRunTick(now);
+    }
+    TRACE_EVENT(core_id, Tracer::DISPATCH, static_cast<int>(process->getPID()), last_core, now);
 
-            queue_condition_.notify_one();
-        }
+    process->setState(Process::ProcessState::RUNNING);
+    process->setCPUCoreID(core_id);
+    CoreStateManager::getInstance().setCoreState(core_id, true, process->getName());
+    setCoreBusy(core_id, true);
 
-        CoreStateManager::getInstance().setCoreState(core_id, false, "");
+    // A process that never ran has no cache to lose
+    if (last_core > 0 && last_core != core_id)
+    {
+        process->addMigration();
+        core_load_[core_id].addMigration(migration_cost_ticks_);
+
+        if (migration_cost_ticks_ > 0)
+        {
+            cpu_clock->waitUntil(tick_slot, cpu_clock->getCpuClock() + migration_cost_ticks_);
+        }
     }
 }
 
 /**
- * @brief Implements Round Robin (RR) scheduling.
- * @param core_id The core ID where the process will run.
+ * @brief Takes the current process off a core, charging the context switch.
+ * @param core_id The core ID.
+ * @param tick_slot The clock tick slot owned by this core.
  */
-void Scheduler::scheduleRR(int core_id)
+void Scheduler::endRun(int core_id, int tick_slot)
 {
-    while (is_running)
-    {
-        std::shared_ptr<Process> process;
+    chargeContextSwitch(core_id, tick_slot);
+    setCoreBusy(core_id, false);
+}
 
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            queue_condition_.wait(lock, [this]
-            {
-                return !process_queue_.empty() || !is_running;
-            });
+/**
+ * @brief Marks a process finished and releases its memory.
+ * @param process The process.
+ */
+void Scheduler::retire(const std::shared_ptr<Process>& process)
+{
+    process->setState(Process::ProcessState::FINISHED);
+    process->setFinishTick(cpu_clock->getCpuClock());
+    cpu_clock->finishWork();
+    metrics_.record(*process);
 
-            if (!is_running)
-            {
-                break;
-            }
+    memory_allocator_->deallocate(process);
+    process->setMemory(nullptr);
+}
 
-            process = process_queue_.front();
-            process_queue_.pop();
+/**
+ * @brief Starts the scheduler and creates worker threads for each core.
+ */
+void Scheduler::start()
+{
+    int count;
+    {
+        std::lock_guard<std::mutex> lock(hotplug_mutex_);
+        is_running = true;
+        count = cpu_count;
+        for (int i = 1; i <= count; ++i)
+        {
+            startCore(i);
         }
+    }
 
-        if (process)
+    {
+        std::unique_lock<std::mutex> lock(start_mutex_);
+        start_condition_.wait(lock, [this, count]
         {
-            {
-                std::lock_guard<std::mutex> lock(active_threads_mutex_);
-                active_threads_++;
-                if (active_threads_ > cpu_count)
-                {
-                    std::cerr << "Error: Exceeded CPU limit!" << std::endl;
-                    active_threads_--;
-                    continue;
-                }
-            }
-
-            void* memory = process->getMemory();
+            return ready_threads >= count;
+        });
+    }
+}
 
-            if (!memory)
-            {
-                memory = memory_allocator_->allocate(process);
-
-                if (memory)
-                {
-                    process->setAllocTime();
-                    process->setMemory(memory);
-                }
-
-                if (!memory)
-                {
-                    do
-                    {
-                        memory_allocator_->deallocateOldest(process->getMemoryRequired());
-                        memory = memory_allocator_->allocate(process);
-                        if (memory)
-                        {
-                            process->setAllocTime();
-                            process->setMemory(memory);
-                        }
-                    }
-                    while (!memory);
-                }
-            }
+/**
+ * @brief Marks a core online and starts its worker thread unless it is still running.
+ * Called with hotplug_mutex_ held.
+ * @param core_id The core ID.
+ */
+void Scheduler::startCore(int core_id)
+{
+    core_online_[core_id] = true;
+    if (core_id > core_slots_)
+    {
+        core_slots_ = core_id;
+    }
 
-            process->setState(Process::ProcessState::RUNNING);
-            process->setCPUCoreID(core_id);
-            CoreStateManager::getInstance().setCoreState(core_id, true, process->getName());
+    // A core taken offline and brought back before its thread left keeps that thread
+    if (core_alive_[core_id])
+    {
+        return;
+    }
 
-            int quantum = 0;
-            int last_clock = cpu_clock->getCpuClock();
-            bool first_command_executed = true;
-            int cycle_counter = 0;
+    if (worker_threads_[core_id].joinable())
+    {
+        worker_threads_[core_id].join();
+    }
+    core_alive_[core_id] = true;
+    worker_threads_[core_id] = std::thread(&Scheduler::run, this, core_id);
+}
 
-            while (process->getCommandCounter() < process->getLinesOfCode() && quantum < quantum_cycle)
-            {
-                if (delay_per_execution != 0)
-                {
-                    std::unique_lock<std::mutex> lock(cpu_clock->getMutex());
-                    cpu_clock->getCondition().wait(lock, [&]
-                    {
-                        return cpu_clock->getCpuClock() > last_clock;
-                    });
-                    last_clock = cpu_clock->getCpuClock();
-                }
-
-                if (!first_command_executed || (++cycle_counter >= delay_per_execution))
-                {
-                    process->executeCurrentCommand();
-                    first_command_executed = false;
-                    cycle_counter = 0;
-                    quantum++;
-                }
-            }
+/**
+ * @brief Lets the worker thread of an offline core exit, handing its queue to the online cores.
+ * @param core_id The core ID.
+ * @return False if the core came back online and the thread should carry on.
+ */
+bool Scheduler::leaveCore(int core_id)
+{
+    std::lock_guard<std::mutex> lock(hotplug_mutex_);
+    if (core_online_[core_id])
+    {
+        return false;
+    }
 
-            std::this_thread::sleep_for(std::chrono::microseconds(2000));
+    core_alive_[core_id] = false;
 
-            if (process->getCommandCounter() < process->getLinesOfCode())
-            {
-                process->setState(Process::ProcessState::READY);
-                std::lock_guard<std::mutex> lock(queue_mutex_);
-                process_queue_.push(process);
-            }
-            else
-            {
-                process->setState(Process::ProcessState::FINISHED);
-                memory_allocator_->deallocate(process);
-                process->setMemory(nullptr);
-            }
+    // One extra wake-up covers a wake-up this core took for itself on the way out
+    int moved = policy_->drainCore(core_id);
+    for (int i = 0; i <= moved; ++i)
+    {
+        wakeIdleCore();
+    }
+    return true;
+}
 
-            {
-                std::lock_guard<std::mutex> lock(active_threads_mutex_);
-                active_threads_--;
-            }
+/**
+ * @brief Stops the scheduler and joins all worker threads.
+ */
+void Scheduler::stop()
+{
+    {
+        // No core can be brought online once this is set
+        std::lock_guard<std::mutex> hotplug_lock(hotplug_mutex_);
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        is_running = false;
+    }
+    idle_condition_.notify_all();
 
-            queue_condition_.notify_one();
+    for (auto& thread : worker_threads_)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
         }
+    }
+}
 
-        CoreStateManager::getInstance().setCoreState(core_id, false, "");
+/**
+ * @brief Main run loop for each worker thread.
+ * @param core_id The core ID where the process will run.
+ */
+void Scheduler::run(int core_id)
+{
+    CpuAffinity::getInstance().pinCore(core_id);
+    int tick_slot = cpu_clock->registerParticipant();
+
+    {
+        std::lock_guard<std::mutex> lock(start_mutex_);
+        ready_threads++;
+    }
+    start_condition_.notify_one();
+
+    // One virtual call per core; the dispatch loop itself is compiled for the concrete policy.
+    // It returns when the scheduler stops or the core goes offline.
+    while (true)
+    {
+        policy_->runCore(*this, core_id, tick_slot);
+        if (!is_running || leaveCore(core_id))
+        {
+            break;
+        }
     }
+
+    cpu_clock->unregisterParticipant(tick_slot);
 }
 
 /**
@@ -2,11 +2,19 @@
 #define SCHEDULER_H
 
 #include "Clock.h"
+#include "CoreLoad.h"
 #include "FlatMemoryAllocator.h"
-#include <queue>
+#include "Process.h"
+#include "RunLog.h"
+#include "SchedulingMetrics.h"
+#include "SchedulingPolicy.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <atomic>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <deque>
 #include <vector>
 #include <memory>
 #include <fstream>
@@ -14,23 +22,30 @@
 #include <map>
 #include <tuple>
 
-// Forward declaration of Process class
-class Process;
-
 /**
  * @class Scheduler
  * @brief Handles the scheduling of processes across multiple CPU cores.
  *
- * This class implements various scheduling algorithms such as First Come First Serve (FCFS)
- * and Round Robin (RR) to manage processes and allocate them to CPU cores. It also handles
- * memory logging and state management for processes.
+ * The scheduling decisions (which process next, how long it runs, where it goes when preempted)
+ * belong to a SchedulingPolicy chosen by name from the PolicyRegistry, e.g. First Come First
+ * Serve (FCFS) or Round Robin (RR). The scheduler owns the worker threads and everything that is
+ * the same for every policy: dispatch, memory allocation, clock pacing and load accounting. It
+ * also handles memory logging and state management for processes.
+ *
+ * Cores can be brought online and taken offline while the scheduler runs (see setOnlineCores).
+ * Every core up to MAX_CORES has its load counters and ready queue from the start, so a core
+ * that comes back keeps its history.
  */
 class Scheduler
 {
 public:
+    static constexpr int MAX_BATCH = 64; ///< Most instructions run per batch when delay-per-exec is 0.
+    static constexpr int MAX_CORES = 128; ///< Most cores that can be online at once.
+    static_assert(MAX_CORES + 16 <= Clock::MAX_TICK_SLOTS, "Every core needs its own clock tick slot, with room for generator threads");
+
     /**
      * @brief Constructor for Scheduler.
-     * @param scheduler_algo The scheduling algorithm to be used (e.g., FCFS, RR).
+     * @param scheduler_algo The registered name of the scheduling policy (e.g. "fcfs", "rr").
      * @param delays_per_exec The delay per execution cycle.
      * @param n_cpu Number of CPU cores.
      * @param quantum_cycle Quantum cycle for RR scheduling.
@@ -39,6 +54,8 @@ public:
      */
     Scheduler(std::string scheduler_algo, int delays_per_exec, int n_cpu, int quantum_cycle, Clock* cpu_clock, IMemoryAllocator* memory_allocator);
 
+    ~Scheduler();
+
     /**
      * @brief Adds a new process to the scheduler.
      * @param process Shared pointer to the process to be added.
@@ -49,10 +66,113 @@ public:
     void setNumCPUs(int num);
     void setDelays(int delay);
     void setQuantumCycle(int quantum_cycle);
+    void setContextSwitchTicks(int ticks);
+    void setMigrationCostTicks(int ticks);
+
+    /**
+     * @brief Sets the log every scheduling decision is recorded to or replayed from. Call before start().
+     * @param run_log The log, or nullptr for none.
+     */
+    void setRunLog(RunLog* run_log);
+
+    /**
+     * @brief Sets the policy-specific settings and recreates the policy.
+     * @param config The settings; core count, quantum and clock are filled in by the scheduler.
+     */
+    void setPolicyConfig(const PolicyConfig& config);
+
+    /**
+     * @brief Grows or shrinks the number of online cores while the scheduler runs.
+     * New cores start taking work at once. A core that goes offline preempts its current
+     * process and hands it, with the rest of its queue, to the remaining cores.
+     * @param num The new number of cores, from 1 to MAX_CORES.
+     */
+    void setOnlineCores(int num);
+
     void start();
     void stop();
     void setCPUClock(Clock* cpu_clock);
 
+    /**
+     * @brief Gets the number of CPU cores.
+     * @return The number of cores.
+     */
+    int getNumCPUs() const;
+
+    /**
+     * @brief Gets the number of cores that have been online at some point.
+     * Their load counters stay valid after they go offline.
+     * @return The highest core ID ever online.
+     */
+    int getCoreSlots() const;
+
+    /**
+     * @brief Checks whether a core is online.
+     * @param core_id The core ID (starting at 1).
+     * @return True if the core takes work.
+     */
+    bool isCoreOnline(int core_id) const;
+
+    /**
+     * @brief Gets the load counters of a core.
+     * @param core_id The core ID (starting at 1).
+     * @return Reference to the core's load counters.
+     */
+    const CoreLoad& getCoreLoad(int core_id) const;
+
+    /**
+     * @brief Gets the decayed length of a core's run queue.
+     * @param core_id The core ID (starting at 1).
+     * @return Reference to the run-queue load average.
+     */
+    const LoadAverage& getRunQueueLoad(int core_id) const;
+
+    /**
+     * @brief Gets the mean turnaround time of finished processes.
+     * @return Mean ticks from admission to completion, or 0 if none finished yet.
+     */
+    double getMeanTurnaround() const;
+
+    /**
+     * @brief Gets the number of processes that ran to completion.
+     * @return The count.
+     */
+    long long getFinishedProcesses() const;
+
+    /**
+     * @brief Gets the wait, response and turnaround distributions of finished processes.
+     * @return Reference to the metrics.
+     */
+    const SchedulingMetrics& getMetrics() const;
+
+    /**
+     * @brief Gets the active scheduling policy.
+     * @return Reference to the policy.
+     */
+    const SchedulingPolicy& getPolicy() const;
+
+    /**
+     * @brief Gets the number of processes waiting for memory.
+     * @return The length of the memory-wait queue.
+     */
+    size_t getMemoryWaiting();
+
+    /**
+     * @brief Gets the ticks processes have spent waiting for memory.
+     * @return Memory stall ticks of every process that left the memory-wait queue.
+     */
+    long long getMemoryStallTicks() const;
+
+    /**
+     * @brief Runs the dispatch loop of one core under a policy until the scheduler stops or the core goes offline.
+     * Called by the policy's runCore, which fixes Policy at compile time.
+     * @param policy The scheduling policy.
+     * @param core_id The core ID where processes will run.
+     * @param tick_slot The clock tick slot owned by this core.
+     */
+    template <typename Policy>
+    void schedule(Policy& policy, int core_id, int tick_slot);
+
 private:
     /**
      * @brief Main run method for the scheduler.
@@ -61,47 +181,359 @@ private:
     void run(int core_id);
 
     /**
-     * @brief Implements First Come First Serve (FCFS) scheduling.
-     * @param core_id The core ID where the process will run.
+     * @brief Marks a core online and starts its worker thread unless it is still running.
+     * Called with hotplug_mutex_ held.
+     * @param core_id The core ID.
      */
-    void scheduleFCFS(int core_id);
+    void startCore(int core_id);
 
     /**
-     * @brief Implements Round Robin (RR) scheduling.
-     * @param core_id The core ID where the process will run.
+     * @brief Lets the worker thread of an offline core exit, handing its queue to the online cores.
+     * @param core_id The core ID.
+     * @return False if the core came back online and the thread should carry on.
      */
-    void scheduleRR(int core_id);
+    bool leaveCore(int core_id);
 
     /**
-     * @brief Logs the current memory state for diagnostics.
-     * @param cycle The cycle number for which the memory is being logged.
+     * @brief Creates the policy named by scheduler_algorithm, falling back to FCFS.
      */
-    void logMemoryState(int cycle);
+    void createPolicy();
+
+    /**
+     * @brief Gets the next process for a core from the policy, parking the core while there is none.
+     * With a run log, the pick is a decision that stays open until schedule() has loaded the process.
+     * @param policy The scheduling policy.
+     * @param core_id The core asking for work.
+     * @param tick_slot The clock tick slot owned by this core.
+     * @return The next process, or nullptr if the scheduler is stopping or the core went offline.
+     */
+    template <typename Policy>
+    std::shared_ptr<Process> nextProcess(Policy& policy, int core_id, int tick_slot);
+
+    /**
+     * @brief Starts a decision in the run log, if there is one.
+     * @param core_id The core making the decision.
+     */
+    void beginDecision(int core_id)
+    {
+        if (run_log_)
+        {
+            run_log_->begin(core_id);
+        }
+    }
+
+    /**
+     * @brief Finishes a decision in the run log, if there is one.
+     * @param core_id The core that made the decision.
+     * @param type The kind of decision.
+     * @param process The process it concerned.
+     * @param value The event-specific value, see RunLog::EventType.
+     */
+    void endDecision(int core_id, RunLog::EventType type, const Process& process, int value)
+    {
+        if (run_log_)
+        {
+            run_log_->end(core_id, type, static_cast<int>(process.getPID()), value);
+        }
+    }
 
     /**
-     * @brief Starts a memory logging thread that tracks memory state periodically.
+     * @brief Parks the calling core on the clock until a process is queued, the core goes
+     * offline or the scheduler stops.
+     * @param core_id The calling core.
      */
-    void startMemoryLog();
+    void waitForWork(int core_id);
 
-    bool memory_log_ = false;        ///< Flag to indicate if memory logging is enabled.
-    bool is_running;                   ///< Flag to indicate if the scheduler is running.
+    /**
+     * @brief Hands a wake-up to one idle core, if any, after a process was queued.
+     */
+    void wakeIdleCore();
+
+    /**
+     * @brief Counts a core as running a process.
+     * @return False if every core is already counted.
+     */
+    bool acquireCore();
+
+    /**
+     * @brief Counts a core as no longer running a process.
+     * @param core_id The core ID.
+     */
+    void releaseCore(int core_id);
+
+    /**
+     * @brief Makes sure a process has memory, evicting the oldest process once if it does not fit.
+     * A process that still does not fit is parked in the memory-wait queue.
+     * @param process The process about to run.
+     * @param core_id The core that picked it.
+     * @return How it was loaded; the process can run unless this is RunLog::MEMORY_WAIT.
+     */
+    RunLog::LoadOutcome loadProcess(const std::shared_ptr<Process>& process, int core_id);
+
+    /**
+     * @brief Moves the longest-waiting process, if any, from the memory-wait queue back to the policy.
+     * Called whenever memory is freed.
+     * @param core_id The core that freed the memory; its queue takes the process.
+     */
+    void wakeMemoryWaiter(int core_id);
+
+    /**
+     * @brief Puts a process on a core, charging the cold cache if it last ran elsewhere.
+     * @param process The process.
+     * @param core_id The core ID.
+     * @param tick_slot The clock tick slot owned by this core.
+     */
+    void beginRun(const std::shared_ptr<Process>& process, int core_id, int tick_slot);
+
+    /**
+     * @brief Takes the current process off a core, charging the context switch.
+     * @param core_id The core ID.
+     * @param tick_slot The clock tick slot owned by this core.
+     */
+    void endRun(int core_id, int tick_slot);
+
+    /**
+     * @brief Marks a process finished and releases its memory.
+     * @param process The process.
+     */
+    void retire(const std::shared_ptr<Process>& process);
+
+    /**
+     * @brief Marks a core busy or idle on the clock and in its load counters.
+     * @param core_id The core ID.
+     * @param busy True if the core started running a process.
+     */
+    void setCoreBusy(int core_id, bool busy);
+
+    /**
+     * @brief Charges a context switch to a core, keeping it busy for the configured number of ticks.
+     * @param core_id The core ID.
+     * @param tick_slot The clock tick slot owned by this core.
+     */
+    void chargeContextSwitch(int core_id, int tick_slot);
+
+    /**
+     * @brief Evicts the oldest resident process that is not running, if there is one.
+     * @param process The process that needs memory.
+     * @return True if a process was evicted.
+     */
+    bool evictFor(std::shared_ptr<Process> process);
+
+    /**
+     * @brief Logs the current memory state for diagnostics.
+     * @param cycle The cycle number for which the memory is being logged.
+     */
+    void logMemoryState(int cycle);
+
+    std::atomic<bool> is_running;      ///< Flag to indicate if the scheduler is running.
     int active_threads_;             ///< Number of active worker threads.
-    int cpu_count;                      ///< Number of CPU cores.
+    std::atomic<int> cpu_count;         ///< Number of online CPU cores.
     int delay_per_execution;             ///< Delay per execution cycle.
     int quantum_cycle;              ///< Quantum cycle for RR scheduling.
+    int context_switch_ticks_ = 0;  ///< Ticks charged to a core each time it switches processes.
+    int migration_cost_ticks_ = 0;  ///< Ticks charged to a core that resumes a process from another core.
     int ready_threads;              ///< Number of threads ready for execution.
-    std::string scheduler_algorithm;     ///< The algorithm used for scheduling.
-    std::queue<std::shared_ptr<Process>> process_queue_; ///< Queue of processes to be scheduled.
-    std::vector<std::thread> worker_threads_; ///< List of worker threads for executing processes.
-    std::mutex queue_mutex_;         ///< Mutex for protecting access to the process queue.
+    std::atomic<int> idle_waiters_{0}; ///< Cores parked with nothing to run.
+    int idle_wakeups_ = 0;          ///< Wake-ups handed to idle cores but not yet consumed.
+    std::string scheduler_algorithm;     ///< Registered name of the scheduling policy.
+    PolicyConfig policy_config_;     ///< Policy-specific settings from config.txt.
+    std::unique_ptr<SchedulingPolicy> policy_; ///< The scheduling policy.
+    std::vector<std::thread> worker_threads_; ///< Worker thread of each core, indexed by core ID.
+    std::unique_ptr<std::atomic<bool>[]> core_online_; ///< Whether each core takes work, indexed by core ID.
+    std::vector<bool> core_alive_;   ///< Whether each core's worker thread is still running; guarded by hotplug_mutex_.
+    std::atomic<int> core_slots_{0}; ///< Highest core ID ever online.
+    std::mutex hotplug_mutex_;       ///< Serializes bringing cores online and offline.
+    std::mutex idle_mutex_;          ///< Mutex for parking and waking idle cores.
     std::mutex active_threads_mutex_;///< Mutex for protecting active thread count.
-    std::condition_variable queue_condition_; ///< Condition variable for process queue.
+    std::condition_variable idle_condition_; ///< Condition variable for idle cores.
     std::mutex start_mutex_;         ///< Mutex for synchronizing the start of threads.
     std::mutex log_mutex_;           ///< Mutex for synchronizing logging activities.
     std::condition_variable start_condition_; ///< Condition variable to start worker threads.
     Clock* cpu_clock;            ///< Pointer to the CPU clock.
     IMemoryAllocator* memory_allocator_; ///< Pointer to the memory allocator.
-    std::thread memory_logging_thread_; ///< Thread for logging memory usage.
+    std::unique_ptr<CoreLoad[]> core_load_; ///< Load counters for each core, indexed by core ID.
+    SchedulingMetrics metrics_;      ///< Wait, response and turnaround of finished processes.
+    std::mutex memory_wait_mutex_;   ///< Guards memory_wait_.
+    std::deque<std::pair<std::shared_ptr<Process>, int>> memory_wait_; ///< Processes waiting for memory, with the tick they started waiting.
+    std::atomic<long long> memory_stall_ticks_{0}; ///< Ticks spent in the memory-wait queue.
+    RunLog* run_log_ = nullptr;      ///< Log the decisions are recorded to or replayed from, or nullptr.
 };
 
+/**
+ * @brief Runs the dispatch loop of one core under a policy until the scheduler stops or the core goes offline.
+ * @param policy The scheduling policy.
+ * @param core_id The core ID where processes will run.
+ * @param tick_slot The clock tick slot owned by this core.
+ *
+ * Every instruction takes delay-per-exec cycles (at least one). The policy decides how many
+ * instructions a process may run before it is preempted and where it goes afterwards. With
+ * delay-per-exec 0, instructions run in batches of up to MAX_BATCH; on the virtual clock a batch
+ * still takes a tick per instruction, while on the real clock it runs without waiting and the core
+ * only waits for the next tick at the end of each slice. Either way a process is charged a tick per
+ * instruction cycle it ran, which is what its virtual runtime, the policy and the trace see, not
+ * the time that passed.
+ */
+template <typename Policy>
+void Scheduler::schedule(Policy& policy, int core_id, int tick_slot)
+{
+    int step = std::max(delay_per_execution, 1);
+
+    while (is_running)
+    {
+        // Returns nullptr once the core goes offline as well
+        std::shared_ptr<Process> process = nextProcess(policy, core_id, tick_slot);
+
+        if (!process)
+        {
+            break;
+        }
+
+        if (!acquireCore())
+        {
+            policy.resume(process, core_id);
+            endDecision(core_id, RunLog::PICK, *process, RunLog::NO_CORE);
+            continue;
+        }
+
+        RunLog::LoadOutcome loaded = loadProcess(process, core_id);
+        endDecision(core_id, RunLog::PICK, *process, loaded);
+        if (loaded == RunLog::MEMORY_WAIT)
+        {
+            // The process waits for memory; run something that is resident meanwhile
+            releaseCore(core_id);
+            continue;
+        }
+
+        beginRun(process, core_id, tick_slot);
+
+        int slice = policy.timeSlice(*process, core_id);
+        int start_clock = cpu_clock->getCpuClock();
+        int last_clock = start_clock;
+        int executed = 0;
+        int charged = 0;
+
+        while (process->getCommandCounter() < process->getLinesOfCode())
+        {
+            if (!core_online_[core_id].load(std::memory_order_relaxed))
+            {
+                // The core was taken offline; the process goes back to be drained to another core
+                break;
+            }
+
+            if (executed == slice)
+            {
+                // The policy may let the process carry on without paying for a switch
+                beginDecision(core_id);
+                bool keep = policy.keepRunning(*process, core_id);
+                endDecision(core_id, RunLog::KEEP, *process, keep);
+                if (!keep)
+                {
+                    break;
+                }
+                slice += policy.timeSlice(*process, core_id);
+            }
+
+            if (delay_per_execution == 0)
+            {
+                // Without a delay there is nothing to watch between instructions, so run the
+                // rest of the slice in one go. Only the virtual clock needs the batch to wait
+                // for its ticks, since it moves only when the cores wait; the real clock does not,
+                // so the batch is charged its instructions rather than the time that passed.
+                int count = std::min({slice - executed, process->getLinesOfCode() - process->getCommandCounter(), MAX_BATCH});
+                if (cpu_clock->isVirtual())
+                {
+                    last_clock = cpu_clock->waitUntil(tick_slot, last_clock + count);
+                }
+                int ran = process->executeCommands(count);
+                executed += ran;
+                charged += ran;
+
+                if (!cpu_clock->isVirtual() && (executed == slice || process->getCommandCounter() >= process->getLinesOfCode()))
+                {
+                    // Block on the clock once per slice, so a busy core still gives up the host CPU
+                    last_clock = cpu_clock->waitUntil(tick_slot, cpu_clock->getCpuClock() + 1);
+                }
+            }
+            else
+            {
+                last_clock = cpu_clock->waitUntil(tick_slot, last_clock + step);
+                process->executeCurrentCommand();
+                executed++;
+                charged += step;
+            }
+        }
+
+        int ticks = charged;
+        process->addVirtualRuntime(ticks);
+        endRun(core_id, tick_slot);
+
+        beginDecision(core_id);
+        if (process->getCommandCounter() < process->getLinesOfCode())
+        {
+            int now = cpu_clock->getCpuClock();
+            process->setState(Process::ProcessState::READY);
+            process->setReadySince(now);
+            process->addPreemption(now);
+            TRACE_EVENT(core_id, Tracer::PREEMPT, static_cast<int>(process->getPID()), ticks, now);
+            policy.requeue(process, core_id, ticks);
+            wakeIdleCore();
+            endDecision(core_id, RunLog::PREEMPT, *process, executed);
+        }
+        else
+        {
+            TRACE_EVENT(core_id, Tracer::FINISH, static_cast<int>(process->getPID()), ticks, cpu_clock->getCpuClock());
+            policy.finish(process, core_id, ticks);
+            retire(process);
+            wakeMemoryWaiter(core_id);
+            endDecision(core_id, RunLog::FINISH, *process, executed);
+        }
+
+        releaseCore(core_id);
+    }
+}
+
+/**
+ * @brief Gets the next process for a core from the policy, parking the core while there is none.
+ * With a run log, the pick is a decision that stays open until schedule() has loaded the process.
+ * @param policy The scheduling policy.
+ * @param core_id The core asking for work.
+ * @param tick_slot The clock tick slot owned by this core.
+ * @return The next process, or nullptr if the scheduler is stopping or the core went offline.
+ */
+template <typename Policy>
+std::shared_ptr<Process> Scheduler::nextProcess(Policy& policy, int core_id, int tick_slot)
+{
+    while (is_running && core_online_[core_id].load())
+    {
+        // A replayed core picks at the ticks it picked in the recording, and waits on the clock
+        // rather than parking in between, so no other core has to wake it
+        int due = run_log_ ? run_log_->nextTick(core_id) : -1;
+        if (due == RunLog::NOT_STARTED)
+        {
+            waitForWork(core_id);
+            continue;
+        }
+        if (due > cpu_clock->getCpuClock())
+        {
+            cpu_clock->waitUntil(tick_slot, due);
+            continue;
+        }
+
+        beginDecision(core_id);
+        std::shared_ptr<Process> process = policy.pickNext(core_id);
+        if (process)
+        {
+            return process;
+        }
+        if (run_log_)
+        {
+            run_log_->cancel(core_id);
+        }
+
+        waitForWork(core_id);
+    }
+
+    return nullptr;
+}
+
 #endif
@@ -0,0 +1,174 @@
+#include "SchedulingMetrics.h"
+
+#include "Process.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <utility>
+
+/**
+ * @brief Record one value. Negative values count as 0.
+ * @param ticks The value.
+ */
+void TickHistogram::record(long long ticks)
+{
+    ticks = std::max(ticks, 0LL);
+    buckets_[bucketOf(ticks)].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(ticks, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the number of values recorded.
+ * @return The count.
+ */
+long long TickHistogram::count() const
+{
+    return count_.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the exact mean of the values recorded.
+ * @return The mean, or 0 if there are none.
+ */
+double TickHistogram::mean() const
+{
+    long long values = count();
+    return values > 0 ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / values : 0.0;
+}
+
+/**
+ * @brief Get the value below which a fraction of the recorded values fall.
+ * @param fraction The fraction, e.g. 0.99 for p99.
+ * @return The highest value of the bucket holding that rank, or 0 if there are none.
+ */
+long long TickHistogram::percentile(double fraction) const
+{
+    // Walk the buckets rather than trusting count_, which a concurrent record may be ahead of
+    long long total = 0;
+    for (const auto& bucket : buckets_)
+    {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    long long rank = std::max(1LL, static_cast<long long>(std::ceil(fraction * total)));
+    long long seen = 0;
+    for (int bucket = 0; bucket < NUM_BUCKETS; ++bucket)
+    {
+        seen += buckets_[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            return bucket + 1 < NUM_BUCKETS ? lowestOf(bucket + 1) - 1 : lowestOf(bucket);
+        }
+    }
+    return lowestOf(NUM_BUCKETS - 1);
+}
+
+/**
+ * @brief Find the bucket of a non-negative value.
+ * @param ticks The value.
+ * @return The bucket index.
+ */
+int TickHistogram::bucketOf(long long ticks)
+{
+    if (ticks < SUB_BUCKETS)
+    {
+        return static_cast<int>(ticks);
+    }
+
+    // SUB_BUCKETS is 2^4: keep the top five bits of the value
+    int exponent = 63 - __builtin_clzll(static_cast<unsigned long long>(ticks));
+    int sub = static_cast<int>((ticks >> (exponent - 4)) & (SUB_BUCKETS - 1));
+    return SUB_BUCKETS + (exponent - 4) * SUB_BUCKETS + sub;
+}
+
+/**
+ * @brief Get the lowest value that falls in a bucket.
+ * @param bucket The bucket index.
+ * @return The value.
+ */
+long long TickHistogram::lowestOf(int bucket)
+{
+    if (bucket < SUB_BUCKETS)
+    {
+        return bucket;
+    }
+
+    int exponent = (bucket - SUB_BUCKETS) / SUB_BUCKETS + 4;
+    long long sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub) << (exponent - 4);
+}
+
+/**
+ * @brief Add a finished process to the distributions.
+ * @param process The process; its finish tick must be set.
+ */
+void SchedulingMetrics::record(const Process& process)
+{
+    int arrival = process.getArrivalTick();
+
+    wait_.record(process.getWaitTicks());
+    response_.record(process.getFirstRunTick() - arrival);
+    turnaround_.record(process.getFinishTick() - arrival);
+    preemptions_.fetch_add(process.getPreemptions(), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the number of processes recorded.
+ * @return The count.
+ */
+long long SchedulingMetrics::getFinished() const
+{
+    return turnaround_.count();
+}
+
+/**
+ * @brief Get the mean turnaround of the processes recorded.
+ * @return Mean ticks from arrival to completion, or 0 if none finished yet.
+ */
+double SchedulingMetrics::getMeanTurnaround() const
+{
+    return turnaround_.mean();
+}
+
+/**
+ * @brief Print mean, p50 and p99 of each metric and the throughput.
+ * @param out Output stream to print to.
+ * @param now The current tick, for the throughput.
+ */
+void SchedulingMetrics::report(std::ostream& out, int now) const
+{
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    long long finished = getFinished();
+    double throughput = now > 0 ? 1000.0 * finished / now : 0.0;
+    double preemptions = finished > 0 ? static_cast<double>(preemptions_.load(std::memory_order_relaxed)) / finished : 0.0;
+
+    out << "------------------------------------------" << std::endl;
+    out << "Scheduling metrics (" << finished << " finished, " << std::fixed << std::setprecision(2)
+        << throughput << " per 1000 ticks)" << std::endl;
+    out << "Ticks             Mean       p50       p99" << std::endl;
+
+    const std::pair<const char*, const TickHistogram*> rows[] = {
+        {"Wait", &wait_},
+        {"Response", &response_},
+        {"Turnaround", &turnaround_},
+    };
+    for (const auto& row : rows)
+    {
+        out << std::left << std::setw(12) << row.first << std::right
+            << std::setw(10) << std::setprecision(1) << row.second->mean()
+            << std::setw(10) << row.second->percentile(0.50)
+            << std::setw(10) << row.second->percentile(0.99) << std::endl;
+    }
+    out << "Preemptions per process: " << std::setprecision(2) << preemptions << std::endl;
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,140 @@
+#ifndef SCHEDULING_METRICS_H
+#define SCHEDULING_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <iostream>
+
+class Process;
+
+/**
+ * @class TickHistogram
+ * @brief Lock-free histogram of tick counts with log-linear buckets.
+ *
+ * Values below SUB_BUCKETS get a bucket each. Above that, every power of two is split into
+ * SUB_BUCKETS equal buckets, so a percentile is never off by more than 1/SUB_BUCKETS of its
+ * value. Recording is a few relaxed atomic adds, so any number of cores can record at once.
+ */
+class TickHistogram
+{
+public:
+    static constexpr int SUB_BUCKETS = 16;                          ///< Buckets per power of two.
+    static constexpr int NUM_BUCKETS = SUB_BUCKETS * 60;            ///< Enough for any non-negative long long.
+
+    /**
+     * @brief Record one value. Negative values count as 0.
+     * @param ticks The value.
+     */
+    void record(long long ticks);
+
+    /**
+     * @brief Get the number of values recorded.
+     * @return The count.
+     */
+    long long count() const;
+
+    /**
+     * @brief Get the exact mean of the values recorded.
+     * @return The mean, or 0 if there are none.
+     */
+    double mean() const;
+
+    /**
+     * @brief Get the value below which a fraction of the recorded values fall.
+     * @param fraction The fraction, e.g. 0.99 for p99.
+     * @return The highest value of the bucket holding that rank, or 0 if there are none.
+     */
+    long long percentile(double fraction) const;
+
+private:
+    static int bucketOf(long long ticks);
+    static long long lowestOf(int bucket);
+
+    std::array<std::atomic<long long>, NUM_BUCKETS> buckets_{}; ///< Values recorded in each bucket.
+    std::atomic<long long> count_{0};                            ///< Values recorded.
+    std::atomic<long long> sum_{0};                              ///< Sum of the values recorded.
+};
+
+/**
+ * @class SchedulingMetrics
+ * @brief Wait, response and turnaround distributions of finished processes.
+ *
+ * - Wait: ticks a process spent ready in a queue, summed over all its dispatches.
+ * - Response: ticks from arrival to first dispatch.
+ * - Turnaround: ticks from arrival to completion.
+ *
+ * Each process keeps its own timestamps while it runs; only the core retiring it touches the
+ * shared histograms, and that without a lock.
+ */
+class SchedulingMetrics
+{
+public:
+    /**
+     * @brief Add a finished process to the distributions.
+     * @param process The process; its finish tick must be set.
+     */
+    void record(const Process& process);
+
+    /**
+     * @brief Get the number of processes recorded.
+     * @return The count.
+     */
+    long long getFinished() const;
+
+    /**
+     * @brief Get the mean turnaround of the processes recorded.
+     * @return Mean ticks from arrival to completion, or 0 if none finished yet.
+     */
+    double getMeanTurnaround() const;
+
+    /**
+     * @brief Get the wait distribution.
+     * @return Ticks spent ready but not running, per process.
+     */
+    const TickHistogram& getWait() const
+    {
+        return wait_;
+    }
+
+    /**
+     * @brief Get the response distribution.
+     * @return Ticks from arrival to first dispatch, per process.
+     */
+    const TickHistogram& getResponse() const
+    {
+        return response_;
+    }
+
+    /**
+     * @brief Get the turnaround distribution.
+     * @return Ticks from arrival to completion, per process.
+     */
+    const TickHistogram& getTurnaround() const
+    {
+        return turnaround_;
+    }
+
+    /**
+     * @brief Get the total preemptions of the processes recorded.
+     * @return The count.
+     */
+    long long getPreemptions() const
+    {
+        return preemptions_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Print mean, p50 and p99 of each metric and the throughput.
+     * @param out Output stream to print to.
+     * @param now The current tick, for the throughput.
+     */
+    void report(std::ostream& out, int now) const;
+
+private:
+    TickHistogram wait_;               ///< Ticks spent ready but not running.
+    TickHistogram response_;           ///< Ticks from arrival to first dispatch.
+    TickHistogram turnaround_;         ///< Ticks from arrival to completion.
+    std::atomic<long long> preemptions_{0}; ///< Preemptions of the processes recorded.
+};
+
+#endif
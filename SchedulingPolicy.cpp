@@ -0,0 +1,53 @@
+#include "SchedulingPolicy.h"
+
+/**
+ * @brief Register a policy under a name.
+ * @param name The name used by the `scheduler` config key.
+ * @param factory Creates the policy.
+ * @return True, so registration can initialise a static.
+ */
+bool PolicyRegistry::add(const std::string& name, Factory factory)
+{
+    factories()[name] = std::move(factory);
+    return true;
+}
+
+/**
+ * @brief Create a policy by name.
+ * @param name The registered name.
+ * @param config The policy settings.
+ * @return The policy, or nullptr if no policy has that name.
+ */
+std::unique_ptr<SchedulingPolicy> PolicyRegistry::create(const std::string& name, const PolicyConfig& config)
+{
+    auto it = factories().find(name);
+    if (it == factories().end())
+    {
+        return nullptr;
+    }
+    return it->second(config);
+}
+
+/**
+ * @brief Get the registered names in alphabetical order.
+ * @return The policy names.
+ */
+std::vector<std::string> PolicyRegistry::names()
+{
+    std::vector<std::string> result;
+    for (const auto& entry : factories())
+    {
+        result.push_back(entry.first);
+    }
+    return result;
+}
+
+/**
+ * @brief Get the factory table. Built on first use so policies can register from static initialisers.
+ * @return The table of factories by name.
+ */
+std::map<std::string, PolicyRegistry::Factory>& PolicyRegistry::factories()
+{
+    static std::map<std::string, Factory> table;
+    return table;
+}
@@ -0,0 +1,150 @@
+#ifndef SCHEDULING_POLICY_H
+#define SCHEDULING_POLICY_H
+
+#include "CoreLoad.h"
+
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Clock;
+class Process;
+class Scheduler;
+
+/**
+ * @struct PolicyConfig
+ * @brief Settings a scheduling policy is built from.
+ */
+struct PolicyConfig
+{
+    int num_cpus = 1;        ///< Number of cores online at first; queues are indexed from 1.
+    int max_cpus = 1;        ///< Most cores that can be brought online later.
+    int quantum_cycles = 1;  ///< Instructions per time slice for preemptive policies.
+    Clock* cpu_clock = nullptr; ///< The simulated clock.
+    int ticks_per_instruction = 1; ///< Ticks each instruction takes.
+    int context_switch_ticks = 0;  ///< Ticks a core is charged for each context switch.
+    int migration_cost_ticks = 0;  ///< Ticks a core is charged to resume a process from another core.
+    bool requeue_affinity = true; ///< Requeue preempted processes on the core they ran on.
+
+    int mlfq_levels = 3;            ///< Number of MLFQ priority levels.
+    std::vector<int> mlfq_quanta;   ///< Quantum of each MLFQ level; missing levels double the previous one.
+    int mlfq_boost_ticks = 1000;    ///< Ticks between MLFQ priority boosts, 0 to disable.
+
+    int stride_default_tickets = 100; ///< Tickets of a process no stride-tickets prefix matches.
+    std::vector<std::pair<std::string, int>> stride_tickets; ///< Tickets by process name prefix; the longest match wins.
+
+    int edf_deadline_ticks = 0;     ///< Deadline given to processes created without one, 0 for best-effort.
+};
+
+/**
+ * @class SchedulingPolicy
+ * @brief Cold-path interface of a scheduling policy.
+ *
+ * A policy owns the pick-next, time-slice and requeue decisions; the Scheduler owns dispatch,
+ * memory allocation and accounting. The per-instruction loop is instantiated for each concrete
+ * policy through Scheduler::schedule<Policy>, so the only virtual calls here are made once per
+ * core thread, once per admitted process, or when reporting.
+ */
+class SchedulingPolicy
+{
+public:
+    virtual ~SchedulingPolicy() = default;
+
+    /**
+     * @brief Run the dispatch loop of one core until the scheduler stops or the core goes offline.
+     * @param scheduler The scheduler that owns the core.
+     * @param core_id The core ID.
+     * @param tick_slot The clock tick slot owned by the core.
+     */
+    virtual void runCore(Scheduler& scheduler, int core_id, int tick_slot) = 0;
+
+    /**
+     * @brief Accept a new process.
+     * @param process The new process.
+     */
+    virtual void admit(std::shared_ptr<Process> process) = 0;
+
+    /**
+     * @brief Put back a process that was picked but could not run, without charging it.
+     * Used when a process returns from the memory-wait queue.
+     * @param process The process.
+     * @param core_id The core whose queue should take it.
+     */
+    virtual void resume(std::shared_ptr<Process> process, int core_id) = 0;
+
+    /**
+     * @brief Set how many cores are online. Cores 1 to count take work from now on.
+     * @param count Number of online cores.
+     */
+    virtual void setOnlineCores(int count) = 0;
+
+    /**
+     * @brief Hand the processes queued on a core that went offline to the online cores.
+     * @param core_id The offline core.
+     * @return Number of processes moved.
+     */
+    virtual int drainCore(int core_id) = 0;
+
+    /**
+     * @brief Check whether any process is waiting to run. Used before an idle core parks.
+     * @return True if some process is ready.
+     */
+    virtual bool hasWork() const = 0;
+
+    /**
+     * @brief Get the decayed length of a core's ready queue.
+     * @param core_id The core ID.
+     * @return The queue-length load average.
+     */
+    virtual const LoadAverage& getQueueLoad(int core_id) const = 0;
+
+    /**
+     * @brief Print policy-specific state, e.g. for process-smi.
+     * @param out Output stream to print to.
+     */
+    virtual void report(std::ostream& out) const
+    {
+        (void)out;
+    }
+};
+
+/**
+ * @class PolicyRegistry
+ * @brief Maps policy names, as written in config.txt, to factories.
+ */
+class PolicyRegistry
+{
+public:
+    using Factory = std::function<std::unique_ptr<SchedulingPolicy>(const PolicyConfig&)>;
+
+    /**
+     * @brief Register a policy under a name.
+     * @param name The name used by the `scheduler` config key.
+     * @param factory Creates the policy.
+     * @return True, so registration can initialise a static.
+     */
+    static bool add(const std::string& name, Factory factory);
+
+    /**
+     * @brief Create a policy by name.
+     * @param name The registered name.
+     * @param config The policy settings.
+     * @return The policy, or nullptr if no policy has that name.
+     */
+    static std::unique_ptr<SchedulingPolicy> create(const std::string& name, const PolicyConfig& config);
+
+    /**
+     * @brief Get the registered names in alphabetical order.
+     * @return The policy names.
+     */
+    static std::vector<std::string> names();
+
+private:
+    static std::map<std::string, Factory>& factories();
+};
+
+#endif
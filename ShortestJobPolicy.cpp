@@ -0,0 +1,14 @@
+#include "ShortestJobPolicy.h"
+
+namespace
+{
+    const bool registered_sjf = PolicyRegistry::add("sjf", [](const PolicyConfig& config)
+    {
+        return std::unique_ptr<SchedulingPolicy>(new SjfPolicy(config));
+    });
+
+    const bool registered_srtf = PolicyRegistry::add("srtf", [](const PolicyConfig& config)
+    {
+        return std::unique_ptr<SchedulingPolicy>(new SrtfPolicy(config));
+    });
+}
@@ -0,0 +1,124 @@
+#ifndef SHORTEST_JOB_POLICY_H
+#define SHORTEST_JOB_POLICY_H
+
+#include "QueuedPolicy.h"
+
+#include <algorithm>
+#include <climits>
+#include <memory>
+#include <queue>
+#include <vector>
+
+/**
+ * @class RemainingQueue
+ * @brief Binary min-heap of ready processes keyed on remaining instructions.
+ *
+ * A queued process does not run, so its key cannot change while it is in the heap. Ties go to
+ * the process that was queued first. Push and pop are O(log n).
+ */
+class RemainingQueue
+{
+public:
+    void push(std::shared_ptr<Process> process)
+    {
+        int remaining = process->getLinesOfCode() - process->getCommandCounter();
+        heap_.push(Entry{remaining, sequence_++, std::move(process)});
+    }
+
+    std::shared_ptr<Process> pop()
+    {
+        std::shared_ptr<Process> process = heap_.top().process;
+        heap_.pop();
+        return process;
+    }
+
+    size_t size() const
+    {
+        return heap_.size();
+    }
+
+    /**
+     * @brief Get the smallest remaining instruction count in the queue.
+     * @return The count, or INT_MAX if the queue is empty.
+     */
+    int minRemaining() const
+    {
+        return heap_.empty() ? INT_MAX : heap_.top().remaining;
+    }
+
+private:
+    /**
+     * @struct Entry
+     * @brief A queued process with its key.
+     */
+    struct Entry
+    {
+        int remaining;                    ///< Instructions left when queued.
+        unsigned long long sequence;      ///< Queue order, for FIFO ties.
+        std::shared_ptr<Process> process; ///< The process.
+
+        bool operator<(const Entry& other) const
+        {
+            // std::priority_queue is a max-heap, so "less" means "runs later"
+            if (remaining != other.remaining)
+            {
+                return remaining > other.remaining;
+            }
+            return sequence > other.sequence;
+        }
+    };
+
+    std::priority_queue<Entry> heap_;     ///< The heap.
+    unsigned long long sequence_ = 0;     ///< Next queue order number.
+};
+
+/**
+ * @class ShortestJobPolicy
+ * @brief Shortest Job First, and its preemptive form Shortest Remaining Time First.
+ *
+ * Each core's queue is a min-heap on remaining instructions, which are known exactly from the
+ * process's command counter. SJF ("sjf") runs the picked process to completion. SRTF ("srtf")
+ * re-checks every quantum-cycles instructions and switches if a shorter process is now waiting
+ * on the core; otherwise the process carries on without a context switch.
+ *
+ * @tparam PREEMPTIVE True for SRTF, false for SJF.
+ */
+template <bool PREEMPTIVE>
+class ShortestJobPolicy : public QueuedPolicy<ShortestJobPolicy<PREEMPTIVE>, RemainingQueue>
+{
+public:
+    using QueuedPolicy<ShortestJobPolicy<PREEMPTIVE>, RemainingQueue>::QueuedPolicy;
+
+    /**
+     * @brief SJF never preempts; SRTF checks for a shorter process every quantum.
+     * @return The time slice in instructions.
+     */
+    int timeSlice(const Process&, int) const
+    {
+        return PREEMPTIVE ? std::max(this->config_.quantum_cycles, 1) : INT_MAX;
+    }
+
+    /**
+     * @brief Keep running unless a shorter process is waiting on this core.
+     * @param process The running process.
+     * @param core_id The core it runs on.
+     * @return True if the process should keep the core.
+     */
+    bool keepRunning(const Process& process, int core_id)
+    {
+        // Let new arrivals compete with the running process
+        this->queues_.mergeAdmission(core_id);
+
+        int remaining = process.getLinesOfCode() - process.getCommandCounter();
+        int shortest = this->queues_.inspect(core_id, [](const RemainingQueue& queue)
+        {
+            return queue.minRemaining();
+        });
+        return remaining <= shortest;
+    }
+};
+
+using SjfPolicy = ShortestJobPolicy<false>;
+using SrtfPolicy = ShortestJobPolicy<true>;
+
+#endif
@@ -0,0 +1,151 @@
+#include "StridePolicy.h"
+
+#include <iomanip>
+
+namespace
+{
+    const bool registered = PolicyRegistry::add("stride", [](const PolicyConfig& config)
+    {
+        return std::unique_ptr<SchedulingPolicy>(new StridePolicy(config));
+    });
+}
+
+/**
+ * @brief Constructor for StridePolicy.
+ * @param config The policy settings.
+ *
+ * Ticket counts below one are raised to one.
+ */
+StridePolicy::StridePolicy(const PolicyConfig& config)
+    : QueuedPolicy(config)
+{
+    groups_.push_back(ShareGroup{"", std::max(config.stride_default_tickets, 1)});
+    for (const auto& entry : config.stride_tickets)
+    {
+        groups_.push_back(ShareGroup{entry.first, std::max(entry.second, 1)});
+    }
+}
+
+/**
+ * @brief Give a new process its group's tickets and start it at the global pass.
+ * @param process The new process.
+ */
+void StridePolicy::admit(std::shared_ptr<Process> process)
+{
+    size_t group = groupOf(process->getName());
+    process->setTickets(groups_[group].tickets);
+    process->setPass(global_pass_.load());
+
+    {
+        std::lock_guard<std::mutex> lock(share_mutex_);
+        groups_[group].active++;
+        active_tickets_ += groups_[group].tickets;
+    }
+
+    queues_.admit(std::move(process));
+}
+
+/**
+ * @brief Charge the slice to the process's pass and queue it again.
+ * @param process The preempted process.
+ * @param core_id The core it ran on.
+ * @param ticks Ticks it ran for.
+ */
+void StridePolicy::requeue(std::shared_ptr<Process> process, int core_id, int ticks)
+{
+    charge(*process, ticks);
+    queues_.requeue(std::move(process), core_id);
+}
+
+/**
+ * @brief Charge the last slice and take the process's tickets out of its group.
+ * @param process The finished process.
+ * @param core_id The core it ran on.
+ * @param ticks Ticks it ran for.
+ */
+void StridePolicy::finish(const std::shared_ptr<Process>& process, int core_id, int ticks)
+{
+    (void)core_id;
+
+    size_t group = charge(*process, ticks);
+
+    std::lock_guard<std::mutex> lock(share_mutex_);
+    groups_[group].active--;
+    active_tickets_ -= groups_[group].tickets;
+}
+
+/**
+ * @brief Find the group of a process by the longest matching name prefix.
+ * @param name The process name.
+ * @return Index into groups_.
+ */
+size_t StridePolicy::groupOf(const std::string& name) const
+{
+    size_t best = 0;
+    for (size_t index = 1; index < groups_.size(); ++index)
+    {
+        const std::string& prefix = groups_[index].prefix;
+        if (name.compare(0, prefix.size(), prefix) == 0 && prefix.size() > groups_[best].prefix.size())
+        {
+            best = index;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Advance a process's pass and account the ticks to its group.
+ * @param process The process that ran.
+ * @param ticks Ticks it ran for.
+ * @return Index of the process's group.
+ *
+ * The ticks are split between the groups in proportion to the tickets they held at the time,
+ * which is the share each group was entitled to.
+ */
+size_t StridePolicy::charge(Process& process, int ticks)
+{
+    process.setPass(process.getPass() + (STRIDE_ONE / process.getTickets()) * ticks);
+
+    size_t group = groupOf(process.getName());
+
+    std::lock_guard<std::mutex> lock(share_mutex_);
+    groups_[group].ticks += ticks;
+    total_ticks_ += ticks;
+    if (active_tickets_ > 0)
+    {
+        for (ShareGroup& share : groups_)
+        {
+            share.entitled_ticks += static_cast<double>(ticks) * share.active * share.tickets / active_tickets_;
+        }
+    }
+    return group;
+}
+
+/**
+ * @brief Print each group's tickets and its achieved share of CPU time against its target.
+ * @param out Output stream to print to.
+ */
+void StridePolicy::report(std::ostream& out) const
+{
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    std::lock_guard<std::mutex> lock(share_mutex_);
+
+    out << "------------------------------------------" << std::endl;
+    out << "Stride shares (" << total_ticks_ << " ticks run)" << std::endl;
+    out << "Prefix               Tickets  Active   Target  Achieved" << std::endl;
+
+    for (const ShareGroup& share : groups_)
+    {
+        double target = total_ticks_ > 0 ? 100.0 * share.entitled_ticks / total_ticks_ : 0.0;
+        double achieved = total_ticks_ > 0 ? 100.0 * share.ticks / total_ticks_ : 0.0;
+
+        out << std::left << std::setw(20) << (share.prefix.empty() ? "(default)" : share.prefix) << std::right
+            << std::setw(8) << share.tickets << std::setw(8) << share.active
+            << std::fixed << std::setprecision(1) << std::setw(8) << target << "%" << std::setw(9) << achieved << "%" << std::endl;
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,175 @@
+#ifndef STRIDE_POLICY_H
+#define STRIDE_POLICY_H
+
+#include "QueuedPolicy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+
+/**
+ * @class PassQueue
+ * @brief Binary min-heap of ready processes keyed on stride pass value.
+ *
+ * Push and pop are O(log n). Ties go to the process that was queued first.
+ */
+class PassQueue
+{
+public:
+    void push(std::shared_ptr<Process> process)
+    {
+        long long pass = process->getPass();
+        heap_.push(Entry{pass, sequence_++, std::move(process)});
+    }
+
+    std::shared_ptr<Process> pop()
+    {
+        std::shared_ptr<Process> process = heap_.top().process;
+        heap_.pop();
+        return process;
+    }
+
+    size_t size() const
+    {
+        return heap_.size();
+    }
+
+private:
+    /**
+     * @struct Entry
+     * @brief A queued process with its key.
+     */
+    struct Entry
+    {
+        long long pass;                   ///< Pass value when queued.
+        unsigned long long sequence;      ///< Queue order, for FIFO ties.
+        std::shared_ptr<Process> process; ///< The process.
+
+        bool operator<(const Entry& other) const
+        {
+            // std::priority_queue is a max-heap, so "less" means "runs later"
+            if (pass != other.pass)
+            {
+                return pass > other.pass;
+            }
+            return sequence > other.sequence;
+        }
+    };
+
+    std::priority_queue<Entry> heap_;     ///< The heap.
+    unsigned long long sequence_ = 0;     ///< Next queue order number.
+};
+
+/**
+ * @class StridePolicy
+ * @brief Proportional-share stride scheduling.
+ *
+ * Each process holds tickets, set from the longest stride-tickets name prefix it matches or
+ * stride-default-tickets otherwise. Its stride is STRIDE_ONE / tickets, and its pass value
+ * advances by stride for every tick it runs. Each core runs the process with the lowest pass
+ * for quantum-cycles instructions, so CPU time goes out in proportion to tickets. New processes
+ * start at the highest pass picked so far.
+ *
+ * Every prefix is a share group; process-smi compares the CPU time each group got against the
+ * share its tickets entitled it to while it had processes to run.
+ */
+class StridePolicy : public QueuedPolicy<StridePolicy, PassQueue>
+{
+public:
+    static constexpr long long STRIDE_ONE = 1 << 20; ///< Stride of a process holding one ticket.
+
+    /**
+     * @brief Constructor for StridePolicy.
+     * @param config The policy settings.
+     */
+    explicit StridePolicy(const PolicyConfig& config);
+
+    void admit(std::shared_ptr<Process> process) override;
+    void report(std::ostream& out) const override;
+
+    /**
+     * @brief Pick the process with the lowest pass and advance the global pass.
+     * @param core_id The core asking for work.
+     * @return The process, or nullptr if nothing is ready.
+     */
+    std::shared_ptr<Process> pickNext(int core_id)
+    {
+        std::shared_ptr<Process> process = queues_.pop(core_id);
+        if (process)
+        {
+            // The global pass only moves forward
+            long long pass = process->getPass();
+            long long current = global_pass_.load();
+            while (pass > current && !global_pass_.compare_exchange_weak(current, pass))
+            {
+            }
+        }
+        return process;
+    }
+
+    /**
+     * @brief Every process gets the same slice; shares come from the ordering.
+     * @return The time slice in instructions.
+     */
+    int timeSlice(const Process&, int) const
+    {
+        return std::max(config_.quantum_cycles, 1);
+    }
+
+    /**
+     * @brief Charge the slice to the process's pass and queue it again.
+     * @param process The preempted process.
+     * @param core_id The core it ran on.
+     * @param ticks Ticks it ran for.
+     */
+    void requeue(std::shared_ptr<Process> process, int core_id, int ticks);
+
+    /**
+     * @brief Charge the last slice and take the process's tickets out of its group.
+     * @param process The finished process.
+     * @param core_id The core it ran on.
+     * @param ticks Ticks it ran for.
+     */
+    void finish(const std::shared_ptr<Process>& process, int core_id, int ticks);
+
+private:
+    /**
+     * @struct ShareGroup
+     * @brief Processes sharing a name prefix, and the CPU time they got against their entitlement.
+     */
+    struct ShareGroup
+    {
+        std::string prefix;           ///< Name prefix, empty for the default group.
+        int tickets;                  ///< Tickets of each process in the group.
+        int active = 0;               ///< Unfinished processes in the group.
+        long long ticks = 0;          ///< Ticks the group's processes ran for.
+        double entitled_ticks = 0.0;  ///< Ticks the group's tickets entitled it to.
+    };
+
+    /**
+     * @brief Find the group of a process by the longest matching name prefix.
+     * @param name The process name.
+     * @return Index into groups_.
+     */
+    size_t groupOf(const std::string& name) const;
+
+    /**
+     * @brief Advance a process's pass and account the ticks to its group.
+     * @param process The process that ran.
+     * @param ticks Ticks it ran for.
+     * @return Index of the process's group.
+     */
+    size_t charge(Process& process, int ticks);
+
+    std::vector<ShareGroup> groups_;    ///< Default group first, then one per stride-tickets prefix.
+    long long active_tickets_ = 0;      ///< Tickets held by unfinished processes.
+    long long total_ticks_ = 0;         ///< Ticks run by all processes.
+    mutable std::mutex share_mutex_;    ///< Guards the share accounting.
+    std::atomic<long long> global_pass_{0}; ///< Highest pass picked so far.
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef TIMED_MUTEX_H
+#define TIMED_MUTEX_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+/**
+ * @struct LockStats
+ * @brief How often a lock was taken and how long it was held.
+ */
+struct LockStats
+{
+    long long acquisitions = 0;  ///< Times the lock was taken.
+    long long contended = 0;     ///< Times it was already held by another thread.
+    long long hold_ns = 0;       ///< Total nanoseconds it was held.
+    long long max_hold_ns = 0;   ///< Longest single hold in nanoseconds.
+};
+
+/**
+ * @class TimedMutex
+ * @brief A std::mutex that counts its acquisitions and hold time. Works with std::lock_guard.
+ *
+ * The counters are only written by the thread holding the lock, so they need no read-modify-write;
+ * they are atomics so getStats() can read them from any thread. The cost is two clock reads per
+ * acquisition, so use it on cold paths such as memory allocation, not per instruction.
+ */
+class TimedMutex
+{
+public:
+    /**
+     * @brief Take the lock, counting whether another thread held it.
+     */
+    void lock()
+    {
+        bool contended = !mutex_.try_lock();
+        if (contended)
+        {
+            mutex_.lock();
+        }
+
+        locked_at_ = std::chrono::steady_clock::now();
+        acquisitions_.store(acquisitions_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (contended)
+        {
+            contended_.store(contended_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Release the lock and add the time it was held.
+     */
+    void unlock()
+    {
+        long long held = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - locked_at_).count();
+        hold_ns_.store(hold_ns_.load(std::memory_order_relaxed) + held, std::memory_order_relaxed);
+        if (held > max_hold_ns_.load(std::memory_order_relaxed))
+        {
+            max_hold_ns_.store(held, std::memory_order_relaxed);
+        }
+        mutex_.unlock();
+    }
+
+    /**
+     * @brief Get the counters. Without the lock, a hold in progress may be half counted.
+     * @return The counters.
+     */
+    LockStats getStats() const
+    {
+        LockStats stats;
+        stats.acquisitions = acquisitions_.load(std::memory_order_relaxed);
+        stats.contended = contended_.load(std::memory_order_relaxed);
+        stats.hold_ns = hold_ns_.load(std::memory_order_relaxed);
+        stats.max_hold_ns = max_hold_ns_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    std::mutex mutex_;                                   ///< The lock itself.
+    std::chrono::steady_clock::time_point locked_at_;    ///< When the current holder took it.
+    std::atomic<long long> acquisitions_{0};             ///< Times the lock was taken.
+    std::atomic<long long> contended_{0};                ///< Times it was already held.
+    std::atomic<long long> hold_ns_{0};                  ///< Total hold time.
+    std::atomic<long long> max_hold_ns_{0};              ///< Longest hold.
+};
+
+#endif
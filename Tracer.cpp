@@ -0,0 +1,209 @@
+#include "Tracer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+std::atomic<bool> Tracer::enabled_{true};
+
+namespace
+{
+    /**
+     * @brief Escape a string for a JSON string literal.
+     * @param text The string.
+     * @return The escaped string, without quotes.
+     */
+    std::string escapeJson(const std::string& text)
+    {
+        std::string escaped;
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                escaped += ' ';
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    const char* const EVENT_NAMES[] = {"dispatch", "preempt", "finish", "evict", "alloc-fail", "memory-wait", "memory-wake"};
+}
+
+/**
+ * @brief Get the singleton instance of Tracer.
+ * @return Reference to the singleton Tracer instance.
+ */
+Tracer& Tracer::getInstance()
+{
+    static Tracer instance;
+    return instance;
+}
+
+/**
+ * @brief Private constructor for singleton pattern.
+ */
+Tracer::Tracer()
+    : rings_(new std::atomic<Ring*>[MAX_RINGS]), start_(std::chrono::steady_clock::now())
+{
+    for (int i = 0; i < MAX_RINGS; ++i)
+    {
+        rings_[i] = nullptr;
+    }
+}
+
+/**
+ * @brief Record an event. Must only be called from the thread that owns the core.
+ * @param core_id The core the event happened on.
+ * @param type What happened.
+ * @param pid The process involved.
+ * @param arg Event-specific value, see EventType.
+ * @param tick The simulated tick.
+ */
+void Tracer::record(int core_id, EventType type, int pid, int arg, int tick)
+{
+    if (core_id < 0 || core_id >= MAX_RINGS)
+    {
+        return;
+    }
+
+    Ring* ring = rings_[core_id].load(std::memory_order_acquire);
+    if (!ring)
+    {
+        // Only this core's thread writes its entry. Rings live until exit, because a core may
+        // still be recording while the program shuts down.
+        ring = new Ring();
+        rings_[core_id].store(ring, std::memory_order_release);
+    }
+
+    std::uint64_t number = ring->head.load(std::memory_order_relaxed);
+    Slot& slot = ring->slots[number & (RING_CAPACITY - 1)];
+    long long wall_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_).count();
+
+    slot.seq.store(2 * number + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.tick.store(tick, std::memory_order_relaxed);
+    slot.pid.store(pid, std::memory_order_relaxed);
+    slot.arg.store(arg, std::memory_order_relaxed);
+    slot.type.store(type, std::memory_order_relaxed);
+    slot.wall_us.store(wall_us, std::memory_order_relaxed);
+    slot.seq.store(2 * number + 2, std::memory_order_release);
+
+    ring->head.store(number + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Write every ring as Chrome trace JSON.
+ * @param path The file to write.
+ * @param names Process name of each PID, for the slice labels.
+ * @param now The current tick; processes still on a core are drawn up to it.
+ * @return Number of events written, or -1 if the file could not be opened.
+ *
+ * A core's run of a process becomes one complete ("X") slice from its dispatch to the matching
+ * preempt or finish, on a track named after the core. Memory events are instants on the same
+ * track.
+ */
+long long Tracer::dump(const std::string& path, const std::map<int, std::string>& names, int now)
+{
+    std::ofstream out(path);
+    if (!out.is_open())
+    {
+        return -1;
+    }
+
+    auto nameOf = [&names](int pid)
+    {
+        auto it = names.find(pid);
+        return it != names.end() ? escapeJson(it->second) : "pid " + std::to_string(pid);
+    };
+
+    long long written = 0;
+    bool first = true;
+    auto separator = [&out, &first]() -> std::ofstream&
+    {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        return out;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    for (int core_id = 0; core_id < MAX_RINGS; ++core_id)
+    {
+        Ring* ring = rings_[core_id].load(std::memory_order_acquire);
+        if (!ring)
+        {
+            continue;
+        }
+
+        // Copy the ring first; slots overwritten while we look are dropped
+        std::vector<Event> events;
+        std::uint64_t head = ring->head.load(std::memory_order_acquire);
+        std::uint64_t oldest = head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+        for (std::uint64_t number = oldest; number < head; ++number)
+        {
+            const Slot& slot = ring->slots[number & (RING_CAPACITY - 1)];
+            std::uint64_t before = slot.seq.load(std::memory_order_acquire);
+            Event event{slot.tick.load(std::memory_order_relaxed), slot.pid.load(std::memory_order_relaxed),
+                        slot.arg.load(std::memory_order_relaxed), static_cast<EventType>(slot.type.load(std::memory_order_relaxed)),
+                        slot.wall_us.load(std::memory_order_relaxed)};
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (before == 2 * number + 2 && slot.seq.load(std::memory_order_relaxed) == before)
+            {
+                events.push_back(event);
+            }
+        }
+
+        separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << core_id
+                    << ",\"args\":{\"name\":\"Core " << core_id << "\"}}";
+
+        const Event* running = nullptr;
+        for (const Event& event : events)
+        {
+            if (event.type == DISPATCH)
+            {
+                running = &event;
+                continue;
+            }
+
+            if (event.type == PREEMPT || event.type == FINISH)
+            {
+                // A run whose dispatch was already overwritten has no start to draw from
+                if (running && running->pid == event.pid)
+                {
+                    separator() << "{\"name\":\"" << nameOf(event.pid) << "\",\"cat\":\"run\",\"ph\":\"X\",\"pid\":1,\"tid\":" << core_id
+                                << ",\"ts\":" << running->tick << ",\"dur\":" << event.tick - running->tick
+                                << ",\"args\":{\"pid\":" << event.pid << ",\"end\":\"" << EVENT_NAMES[event.type]
+                                << "\",\"wall_us\":" << running->wall_us << ",\"wall_dur_us\":" << event.wall_us - running->wall_us << "}}";
+                    written++;
+                }
+                running = nullptr;
+                continue;
+            }
+
+            separator() << "{\"name\":\"" << EVENT_NAMES[event.type] << "\",\"cat\":\"memory\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":" << core_id
+                        << ",\"ts\":" << event.tick << ",\"args\":{\"process\":\"" << nameOf(event.pid) << "\",\"pid\":" << event.pid
+                        << ",\"arg\":" << event.arg << ",\"wall_us\":" << event.wall_us << "}}";
+            written++;
+        }
+
+        if (running)
+        {
+            separator() << "{\"name\":\"" << nameOf(running->pid) << "\",\"cat\":\"run\",\"ph\":\"X\",\"pid\":1,\"tid\":" << core_id
+                        << ",\"ts\":" << running->tick << ",\"dur\":" << std::max(now - running->tick, 0)
+                        << ",\"args\":{\"pid\":" << running->pid << ",\"end\":\"running\",\"wall_us\":" << running->wall_us << "}}";
+            written++;
+        }
+    }
+
+    out << "\n]}\n";
+    return written;
+}
@@ -0,0 +1,160 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Record a scheduler event on a core's trace ring.
+ *
+ * Compiles to nothing when CSOPESY_NO_TRACE is defined; otherwise it costs one relaxed load and
+ * a predictable branch while tracing is disabled.
+ */
+#ifdef CSOPESY_NO_TRACE
+#define TRACE_EVENT(core_id, type, pid, arg, tick) ((void)0)
+#else
+#define TRACE_EVENT(core_id, type, pid, arg, tick)                                  \
+    do                                                                              \
+    {                                                                               \
+        if (Tracer::isEnabled())                                                    \
+        {                                                                           \
+            Tracer::getInstance().record((core_id), (type), (pid), (arg), (tick));  \
+        }                                                                           \
+    } while (0)
+#endif
+
+/**
+ * @class Tracer
+ * @brief Always-on scheduler event tracing into fixed-size per-core rings, in a singleton pattern.
+ *
+ * Each core writes only its own ring, so recording takes no lock: an event is a handful of
+ * relaxed stores bracketed by a per-slot sequence number. When a ring is full the oldest events
+ * are overwritten. A ring is allocated the first time its core records, so cores that never run
+ * cost no memory.
+ *
+ * dump() copies every ring, skipping slots a core is overwriting at that moment, and writes them
+ * as Chrome trace JSON (chrome://tracing or ui.perfetto.dev). Timestamps are simulated ticks
+ * shown as microseconds, so runs on the virtual and real clocks read the same; the host wall
+ * time of each event is kept in its args.
+ */
+class Tracer
+{
+public:
+    static constexpr int RING_CAPACITY = 4096; ///< Events kept per core; a power of two.
+    static constexpr int MAX_RINGS = 129;      ///< Rings for cores 0 to 128; core 0 is unused by the scheduler.
+
+    /**
+     * @enum EventType
+     * @brief What happened.
+     */
+    enum EventType : std::uint8_t
+    {
+        DISPATCH,     ///< A process was put on the core; arg is the core it last ran on, -1 if none.
+        PREEMPT,      ///< A process left the core unfinished; arg is the ticks it ran.
+        FINISH,       ///< A process ran its last instruction; arg is the ticks it ran.
+        EVICT,        ///< The oldest resident process was evicted to make room for this one.
+        ALLOC_FAIL,   ///< This process did not fit in free memory; arg is the KB it needs.
+        MEMORY_WAIT,  ///< This process was parked in the memory-wait queue.
+        MEMORY_WAKE   ///< This process left the memory-wait queue; arg is the ticks it waited.
+    };
+
+    /**
+     * @brief Get the singleton instance of Tracer.
+     * @return Reference to the singleton Tracer instance.
+     */
+    static Tracer& getInstance();
+
+    /**
+     * @brief Check whether events are being recorded.
+     * @return True if tracing is on.
+     */
+    static bool isEnabled()
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Turn recording on or off. Events already recorded are kept.
+     * @param enabled True to record.
+     */
+    static void setEnabled(bool enabled)
+    {
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Record an event. Must only be called from the thread that owns the core.
+     * @param core_id The core the event happened on.
+     * @param type What happened.
+     * @param pid The process involved.
+     * @param arg Event-specific value, see EventType.
+     * @param tick The simulated tick.
+     */
+    void record(int core_id, EventType type, int pid, int arg, int tick);
+
+    /**
+     * @brief Write every ring as Chrome trace JSON.
+     * @param path The file to write.
+     * @param names Process name of each PID, for the slice labels.
+     * @param now The current tick; processes still on a core are drawn up to it.
+     * @return Number of events written, or -1 if the file could not be opened.
+     */
+    long long dump(const std::string& path, const std::map<int, std::string>& names, int now);
+
+private:
+    /**
+     * @brief Private constructor for singleton pattern.
+     */
+    Tracer();
+
+    // Disable copy constructor and assignment operator to enforce Singleton pattern.
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * @struct Slot
+     * @brief One event. seq is odd while the owning core writes the slot.
+     */
+    struct Slot
+    {
+        std::atomic<std::uint64_t> seq{0};      ///< 2 * (event number + 1) once written.
+        std::atomic<int> tick{0};               ///< Simulated tick.
+        std::atomic<int> pid{0};                ///< Process ID.
+        std::atomic<int> arg{0};                ///< Event-specific value.
+        std::atomic<std::uint8_t> type{0};      ///< EventType.
+        std::atomic<long long> wall_us{0};      ///< Host time since the tracer started.
+    };
+
+    /**
+     * @struct Ring
+     * @brief Events of one core.
+     */
+    struct alignas(64) Ring
+    {
+        std::atomic<std::uint64_t> head{0};     ///< Events ever recorded; the next goes to head % RING_CAPACITY.
+        Slot slots[RING_CAPACITY];              ///< The events.
+    };
+
+    /**
+     * @struct Event
+     * @brief A consistent copy of a slot, made by dump().
+     */
+    struct Event
+    {
+        int tick;
+        int pid;
+        int arg;
+        EventType type;
+        long long wall_us;
+    };
+
+    static std::atomic<bool> enabled_;          ///< Whether record() is called at all.
+    std::unique_ptr<std::atomic<Ring*>[]> rings_; ///< Ring of each core, nullptr until it records.
+    std::chrono::steady_clock::time_point start_; ///< Origin of the wall timestamps.
+};
+
+#endif
@@ -0,0 +1,303 @@
+#include "WorkloadTrace.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Parse a whole field as a number, ignoring surrounding spaces.
+     * @param field The field.
+     * @param value Receives the number.
+     * @return False if the field is not a number.
+     */
+    bool parseField(const std::string& field, long long& value)
+    {
+        const char* begin = field.c_str();
+        char* end = nullptr;
+        errno = 0;
+        value = std::strtoll(begin, &end, 10);
+        if (end == begin || errno == ERANGE)
+        {
+            return false;
+        }
+        while (*end == ' ' || *end == '\t')
+        {
+            ++end;
+        }
+        return *end == '\0';
+    }
+}
+
+/**
+ * @brief Open a trace file and detect its format.
+ * @param path The trace file.
+ * @return False if the file could not be opened or has an unknown binary version.
+ */
+bool WorkloadTrace::open(const std::string& path)
+{
+    in_.open(path, std::ios::binary);
+    if (!in_.is_open())
+    {
+        return false;
+    }
+
+    char magic[sizeof(MAGIC)] = {};
+    in_.read(magic, sizeof(magic));
+    binary_ = in_.gcount() == static_cast<std::streamsize>(sizeof(MAGIC)) && std::equal(magic, magic + sizeof(MAGIC), MAGIC);
+
+    if (binary_)
+    {
+        int version = in_.get();
+        if (version != VERSION)
+        {
+            std::cerr << "Error: Unsupported workload trace version " << version << " in " << path << "." << std::endl;
+            return false;
+        }
+    }
+    else
+    {
+        in_.clear();
+        in_.seekg(0);
+    }
+    return true;
+}
+
+/**
+ * @brief Read the next record. Invalid records are reported to std::cerr and skipped.
+ * @param record Receives the record.
+ * @return False at the end of the trace.
+ */
+bool WorkloadTrace::next(Record& record)
+{
+    while (binary_ ? nextBinary(record) : nextCsv(record))
+    {
+        if (accept(record))
+        {
+            last_arrival_ = record.arrival_tick;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Get the number of invalid records skipped so far.
+ * @return The count.
+ */
+long long WorkloadTrace::getSkipped() const
+{
+    return skipped_;
+}
+
+/**
+ * @brief Read the next CSV line holding a record, without validating it.
+ * @param record Receives the record.
+ * @return False at the end of the file.
+ */
+bool WorkloadTrace::nextCsv(Record& record)
+{
+    std::string line;
+    while (std::getline(in_, line))
+    {
+        line_++;
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (line.find_first_not_of(" \t") == std::string::npos || line[line.find_first_not_of(" \t")] == '#')
+        {
+            continue;
+        }
+
+        std::vector<long long> fields;
+        size_t start = 0;
+        bool numeric = true;
+        while (numeric)
+        {
+            size_t comma = line.find(',', start);
+            long long value = 0;
+            numeric = parseField(line.substr(start, comma - start), value);
+            fields.push_back(value);
+            if (comma == std::string::npos)
+            {
+                break;
+            }
+            start = comma + 1;
+        }
+
+        // A header names the columns; anything else that does not parse is an error
+        bool first = !past_header_;
+        past_header_ = true;
+        if (!numeric && first)
+        {
+            continue;
+        }
+        if (!numeric || fields.size() < 3 || fields.size() > 4)
+        {
+            std::cerr << "Error: Workload trace line " << line_ << " is not arrival_tick,instructions,memory_kb[,priority]." << std::endl;
+            skipped_++;
+            continue;
+        }
+
+        // Out-of-range values become ones accept() rejects
+        long long priority = fields.size() == 4 ? fields[3] : -1;
+        record.arrival_tick = fields[0] < 0 || fields[0] > INT_MAX ? -1 : static_cast<int>(fields[0]);
+        record.instructions = fields[1] < 0 || fields[1] > INT_MAX ? 0 : static_cast<int>(fields[1]);
+        record.memory_kb = fields[2] < 0 ? 0 : static_cast<size_t>(fields[2]);
+        record.priority = priority < -1 || priority > INT_MAX ? -2 : static_cast<int>(priority);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Read the next binary record, without validating it.
+ * @param record Receives the record.
+ * @return False at the end of the file or on a truncated record.
+ */
+bool WorkloadTrace::nextBinary(Record& record)
+{
+    std::uint64_t delta = 0;
+    if (!readVarint(in_, delta))
+    {
+        return false;
+    }
+    line_++;
+
+    std::uint64_t instructions = 0;
+    std::uint64_t memory_kb = 0;
+    std::uint64_t priority = 0;
+    if (!readVarint(in_, instructions) || !readVarint(in_, memory_kb) || !readVarint(in_, priority))
+    {
+        std::cerr << "Error: Workload trace record " << line_ << " is truncated." << std::endl;
+        skipped_++;
+        return false;
+    }
+
+    std::uint64_t arrival = last_arrival_ + delta;
+    record.arrival_tick = arrival > INT_MAX ? -1 : static_cast<int>(arrival);
+    record.instructions = instructions > INT_MAX ? 0 : static_cast<int>(instructions);
+    record.memory_kb = static_cast<size_t>(memory_kb);
+    record.priority = priority > INT_MAX ? -2 : static_cast<int>(priority) - 1;
+    return true;
+}
+
+/**
+ * @brief Check a record, reporting why it is rejected.
+ * @param record The record.
+ * @return True if the record can be replayed.
+ */
+bool WorkloadTrace::accept(const Record& record)
+{
+    const char* problem = nullptr;
+    if (record.arrival_tick < 0)
+    {
+        problem = "arrival tick out of range";
+    }
+    else if (record.arrival_tick < last_arrival_)
+    {
+        problem = "arrives before the previous record";
+    }
+    else if (record.instructions <= 0)
+    {
+        problem = "instruction count out of range";
+    }
+    else if (record.memory_kb == 0)
+    {
+        problem = "memory must be positive";
+    }
+    else if (record.priority < -1)
+    {
+        problem = "priority out of range";
+    }
+
+    if (problem)
+    {
+        std::cerr << "Error: Workload trace " << (binary_ ? "record " : "line ") << line_ << ": " << problem << "." << std::endl;
+        skipped_++;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Write a CSV trace in the binary format.
+ * @param csv_path The CSV trace.
+ * @param binary_path The binary file to write.
+ * @return Number of records written, or -1 if a file could not be opened.
+ */
+long long WorkloadTrace::convert(const std::string& csv_path, const std::string& binary_path)
+{
+    WorkloadTrace trace;
+    if (!trace.open(csv_path))
+    {
+        return -1;
+    }
+
+    std::ofstream out(binary_path, std::ios::binary);
+    if (!out.is_open())
+    {
+        return -1;
+    }
+
+    out.write(MAGIC, sizeof(MAGIC));
+    out.put(static_cast<char>(VERSION));
+
+    long long written = 0;
+    int previous = 0;
+    for (Record record; trace.next(record);)
+    {
+        writeVarint(out, static_cast<std::uint64_t>(record.arrival_tick - previous));
+        writeVarint(out, static_cast<std::uint64_t>(record.instructions));
+        writeVarint(out, static_cast<std::uint64_t>(record.memory_kb));
+        writeVarint(out, static_cast<std::uint64_t>(record.priority + 1));
+        previous = record.arrival_tick;
+        written++;
+    }
+    return written;
+}
+
+/**
+ * @brief Read an unsigned LEB128 varint.
+ * @param in The stream.
+ * @param value Receives the number.
+ * @return False at the end of the stream or if the varint is longer than 64 bits.
+ */
+bool WorkloadTrace::readVarint(std::istream& in, std::uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        int byte = in.get();
+        if (byte == std::char_traits<char>::eof())
+        {
+            return false;
+        }
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Write an unsigned LEB128 varint: seven bits per byte, low bits first.
+ * @param out The stream.
+ * @param value The number.
+ */
+void WorkloadTrace::writeVarint(std::ostream& out, std::uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
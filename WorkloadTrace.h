@@ -0,0 +1,95 @@
+#ifndef WORKLOAD_TRACE_H
+#define WORKLOAD_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+/**
+ * @class WorkloadTrace
+ * @brief Streams process arrivals from a workload trace file, one record at a time.
+ *
+ * Two formats are read, told apart by the first bytes of the file:
+ *
+ * - CSV: one process per line as `arrival_tick,instructions,memory_kb[,priority]`. Blank lines,
+ *   lines starting with '#' and a header line are skipped.
+ * - Binary: the magic "CSWT" and a version byte, then per process four unsigned LEB128 varints:
+ *   ticks since the previous arrival, instructions, memory in KB and priority + 1 (0 for none).
+ *   convert() writes it from a CSV file at about a third of the size.
+ *
+ * Arrival ticks are relative to the start of the replay and must not decrease. The priority is
+ * the starting priority level, 0 being the highest, as used by MLFQ. Only the current record is
+ * held in memory, so traces of any length can be replayed.
+ */
+class WorkloadTrace
+{
+public:
+    /**
+     * @struct Record
+     * @brief One process arrival.
+     */
+    struct Record
+    {
+        int arrival_tick = 0;       ///< Ticks after the start of the replay.
+        int instructions = 0;       ///< Number of instructions.
+        size_t memory_kb = 0;       ///< Memory required in KB.
+        int priority = -1;          ///< Starting priority level, -1 if the trace gives none.
+        int deadline = 0;           ///< Deadline in ticks after arrival, 0 for none. Not stored in trace files.
+    };
+
+    /**
+     * @brief Open a trace file and detect its format.
+     * @param path The trace file.
+     * @return False if the file could not be opened or has an unknown binary version.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Read the next record. Invalid records are reported to std::cerr and skipped.
+     * @param record Receives the record.
+     * @return False at the end of the trace.
+     */
+    bool next(Record& record);
+
+    /**
+     * @brief Get the number of invalid records skipped so far.
+     * @return The count.
+     */
+    long long getSkipped() const;
+
+    /**
+     * @brief Write a CSV trace in the binary format.
+     * @param csv_path The CSV trace.
+     * @param binary_path The binary file to write.
+     * @return Number of records written, or -1 if a file could not be opened.
+     */
+    static long long convert(const std::string& csv_path, const std::string& binary_path);
+
+    /**
+     * @brief Read an unsigned LEB128 varint.
+     * @param in The stream.
+     * @param value Receives the number.
+     * @return False at the end of the stream or if the varint is longer than 64 bits.
+     */
+    static bool readVarint(std::istream& in, std::uint64_t& value);
+
+private:
+    static constexpr char MAGIC[4] = {'C', 'S', 'W', 'T'};
+    static constexpr std::uint8_t VERSION = 1;
+
+    bool nextCsv(Record& record);
+    bool nextBinary(Record& record);
+    bool accept(const Record& record);
+
+    static void writeVarint(std::ostream& out, std::uint64_t value);
+
+    std::ifstream in_;              ///< The trace file.
+    bool binary_ = false;           ///< Whether the file is in the binary format.
+    long long line_ = 0;            ///< CSV line, or binary record, last read; for error messages.
+    bool past_header_ = false;      ///< Whether the first CSV line with content has been read.
+    int last_arrival_ = 0;          ///< Arrival tick of the last record returned.
+    long long skipped_ = 0;         ///< Invalid records skipped.
+};
+
+#endif
@@ -0,0 +1,114 @@
+#include "../Clock.h"
+#include "../ProcessManager.h"
+#include "../StridePolicy.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+
+/**
+ * @file AccountingCheck.cpp
+ * @brief Checks that processes are charged for the instructions they run with delay-per-exec 0.
+ *
+ * On the real clock a batch of instructions runs without waiting for the clock, so the ticks a
+ * process is charged cannot come from the time that passed. For cfs and stride on both clocks,
+ * this runs a few processes to the end and checks that each one's virtual runtime and pass
+ * advanced by at least one tick per instruction. Prints one CSV row per run and exits with 1 if
+ * any process was undercharged.
+ */
+
+namespace
+{
+    constexpr int NUM_PROCESSES = 8;
+    constexpr int INSTRUCTIONS = 200;
+    constexpr auto TIME_LIMIT = std::chrono::seconds(30);
+
+    /**
+     * @brief Run NUM_PROCESSES processes to the end and check what they were charged.
+     * @param scheduler The policy name.
+     * @param mode Clock mode.
+     * @return Number of processes charged less than they ran, or NUM_PROCESSES if the run timed out.
+     */
+    int check(const std::string& scheduler, Clock::ClockMode mode)
+    {
+        Clock clock(mode);
+        clock.startCpuClock();
+
+        int undercharged = 0;
+        {
+            ProcessManager process_manager(INSTRUCTIONS, INSTRUCTIONS, 2, scheduler, 0, 5, &clock, 1024, 1024, 16, 16);
+            for (int i = 0; i < NUM_PROCESSES; ++i)
+            {
+                process_manager.addProcess("accounting_check_" + std::to_string(i), "");
+            }
+
+            // The virtual clock needs a participant that waits, or it would not move on its own
+            int slot = clock.registerParticipant();
+            auto start = std::chrono::steady_clock::now();
+            while (process_manager.getScheduler().getFinishedProcesses() < NUM_PROCESSES)
+            {
+                if (std::chrono::steady_clock::now() - start >= TIME_LIMIT)
+                {
+                    undercharged = NUM_PROCESSES;
+                    break;
+                }
+                clock.waitUntil(slot, clock.getCpuClock() + 1);
+            }
+            clock.unregisterParticipant(slot);
+
+            if (undercharged == 0)
+            {
+                // A process that is missing counts as undercharged too
+                undercharged = NUM_PROCESSES;
+                for (const auto& [name, process] : process_manager.getAllProcess())
+                {
+                    undercharged--;
+                    long long instructions = process->getLinesOfCode();
+                    bool charged = scheduler == "stride"
+                        ? process->getPass() >= instructions * (StridePolicy::STRIDE_ONE / process->getTickets())
+                        : process->getVirtualRuntime() >= instructions;
+                    if (!charged)
+                    {
+                        undercharged++;
+                    }
+                }
+            }
+        }
+        clock.stopCpuClock();
+
+        for (int i = 0; i < NUM_PROCESSES; ++i)
+        {
+            std::remove(("accounting_check_" + std::to_string(i) + ".txt").c_str());
+        }
+        return undercharged;
+    }
+}
+
+/**
+ * @brief Checks cfs and stride on the real and the virtual clock.
+ * @return 0 if every process was charged for what it ran, 1 otherwise.
+ */
+int main()
+{
+    // The emulator prints banners to std::cout; keep them out of the CSV
+    std::streambuf* console = std::cout.rdbuf(nullptr);
+    std::ostream csv(console);
+
+    csv << "scheduler,clock,undercharged" << std::endl;
+    bool passed = true;
+    for (const std::string scheduler : {"cfs", "stride"})
+    {
+        for (Clock::ClockMode mode : {Clock::REAL, Clock::VIRTUAL})
+        {
+            int undercharged = check(scheduler, mode);
+            csv << scheduler << "," << (mode == Clock::REAL ? "real" : "virtual") << "," << undercharged << std::endl;
+            passed = passed && undercharged == 0;
+        }
+    }
+
+    std::cout.rdbuf(console);
+    std::cout.clear();
+    return passed ? 0 : 1;
+}
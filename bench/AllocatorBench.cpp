@@ -0,0 +1,342 @@
+#include "../IMemoryAllocator.h"
+#include "../Process.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @file AllocatorBench.cpp
+ * @brief Replays synthetic allocation traces against every allocator in the AllocatorRegistry.
+ *
+ * A trace is a seeded sequence of allocate, deallocate and deallocateOldest calls with process
+ * sizes drawn from powers of two, the way ProcessManager sizes processes. Three CSV tables are
+ * printed, separated by blank lines:
+ *
+ * - ns per call of each operation, replayed on one thread;
+ * - the fragmentation curve of that replay: resident processes, free memory and failed
+ *   allocations in each window, where a "fragmented" failure is one that had enough free memory
+ *   in total;
+ * - throughput and lock hold time with 1 to 64 threads sharing one allocator, each replaying its
+ *   own allocate/deallocate trace.
+ *
+ * A new allocator shows up in every table once it registers itself with AllocatorRegistry.
+ */
+
+namespace
+{
+    constexpr int TRACE_OPS = 20000;        ///< Calls in the single-thread replay.
+    constexpr int CURVE_POINTS = 20;        ///< Windows in the fragmentation curve.
+    constexpr int THREAD_OPS = 2000;        ///< Calls per thread in the contention replay.
+    constexpr int MAX_THREADS = 64;
+
+    /// Total memory and frame size in KB.
+    const std::pair<size_t, size_t> MEMORY_SIZES[] = {{4096, 16}, {16384, 64}, {65536, 256}};
+
+    enum OpType
+    {
+        ALLOCATE,
+        DEALLOCATE,
+        DEALLOCATE_OLDEST,
+        NUM_OP_TYPES
+    };
+
+    const char* const OP_NAMES[] = {"allocate", "deallocate", "deallocate_oldest"};
+
+    /**
+     * @struct TraceOp
+     * @brief One call of a trace.
+     */
+    struct TraceOp
+    {
+        OpType type;
+        std::shared_ptr<Process> process;   ///< The process to allocate, for ALLOCATE.
+        std::uint32_t pick;                 ///< Chooses the resident process to free, for DEALLOCATE.
+    };
+
+    /**
+     * @brief Build a trace. Processes are created here so the replay times only the allocator.
+     * @param seed Random seed; the same seed gives the same trace.
+     * @param ops Number of calls.
+     * @param memory_kb Total memory; processes take 1/512 to 1/32 of it.
+     * @param frame_kb Frame size.
+     * @param first_pid PID of the first process; PIDs must be unique per allocator.
+     * @param evict Whether to include deallocateOldest calls.
+     * @return The trace.
+     */
+    std::vector<TraceOp> makeTrace(unsigned seed, int ops, size_t memory_kb, size_t frame_kb, int first_pid, bool evict)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<int> percent(0, 99);
+        std::uniform_int_distribution<int> exponent(0, 4);
+        std::uniform_int_distribution<std::uint32_t> pick;
+
+        std::vector<TraceOp> trace;
+        trace.reserve(ops);
+        int pid = first_pid;
+        for (int i = 0; i < ops; ++i)
+        {
+            int roll = percent(gen);
+            if (roll < 55)
+            {
+                size_t size = std::max<size_t>(memory_kb / 512, 1) << exponent(gen);
+                trace.push_back({ALLOCATE, std::make_shared<Process>(pid, "alloc_bench_" + std::to_string(pid), "", -1, 0, 0, size, frame_kb), 0});
+                pid++;
+            }
+            else if (roll < 95 || !evict)
+            {
+                trace.push_back({DEALLOCATE, nullptr, pick(gen)});
+            }
+            else
+            {
+                trace.push_back({DEALLOCATE_OLDEST, nullptr, 0});
+            }
+        }
+        return trace;
+    }
+
+    /**
+     * @brief Nanoseconds since an earlier time.
+     * @param start The earlier time.
+     * @return Elapsed nanoseconds.
+     */
+    long long nanosSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @brief Replay one trace on one thread and print the ns/op rows and the fragmentation curve.
+     * @param name The allocator name.
+     * @param memory_kb Total memory.
+     * @param frame_kb Frame size.
+     * @param timing Stream for the ns/op rows.
+     * @param curve Stream for the fragmentation curve rows.
+     */
+    void benchSingle(const std::string& name, size_t memory_kb, size_t frame_kb, std::ostream& timing, std::ostream& curve)
+    {
+        std::unique_ptr<IMemoryAllocator> allocator = AllocatorRegistry::create(name, memory_kb, frame_kb);
+        std::vector<TraceOp> trace = makeTrace(1, TRACE_OPS, memory_kb, frame_kb, 1, true);
+        std::vector<std::shared_ptr<Process>> resident;
+
+        long long calls[NUM_OP_TYPES] = {};
+        long long nanos[NUM_OP_TYPES] = {};
+        long long failures = 0;
+        long long fragmented = 0;
+        int window = TRACE_OPS / CURVE_POINTS;
+
+        for (int i = 0; i < TRACE_OPS; ++i)
+        {
+            TraceOp& op = trace[i];
+            if (op.type == DEALLOCATE && resident.empty())
+            {
+                op.type = DEALLOCATE_OLDEST;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            if (op.type == ALLOCATE)
+            {
+                void* memory = allocator->allocate(op.process);
+                nanos[ALLOCATE] += nanosSince(start);
+
+                if (memory)
+                {
+                    op.process->setMemory(memory);
+                    resident.push_back(op.process);
+                }
+                else
+                {
+                    failures++;
+                    if (allocator->getExternalFragmentation() >= op.process->getMemoryRequired())
+                    {
+                        fragmented++;
+                    }
+                }
+            }
+            else if (op.type == DEALLOCATE)
+            {
+                size_t index = op.pick % resident.size();
+                start = std::chrono::steady_clock::now();
+                allocator->deallocate(resident[index]);
+                nanos[DEALLOCATE] += nanosSince(start);
+
+                resident[index]->setMemory(nullptr);
+                resident[index] = resident.back();
+                resident.pop_back();
+            }
+            else
+            {
+                allocator->deallocateOldest(0);
+                nanos[DEALLOCATE_OLDEST] += nanosSince(start);
+
+                resident.erase(std::remove_if(resident.begin(), resident.end(), [](const std::shared_ptr<Process>& process)
+                {
+                    return process->getMemory() == nullptr;
+                }), resident.end());
+            }
+            calls[op.type]++;
+
+            if ((i + 1) % window == 0)
+            {
+                curve << name << "," << memory_kb << "," << frame_kb << "," << i + 1 << "," << resident.size() << ","
+                      << allocator->getExternalFragmentation() << "," << failures << "," << fragmented << std::endl;
+                failures = 0;
+                fragmented = 0;
+            }
+        }
+
+        for (int type = 0; type < NUM_OP_TYPES; ++type)
+        {
+            timing << name << "," << memory_kb << "," << frame_kb << "," << OP_NAMES[type] << "," << calls[type] << ","
+                   << std::fixed << std::setprecision(1) << (calls[type] > 0 ? static_cast<double>(nanos[type]) / calls[type] : 0.0)
+                   << std::endl;
+        }
+
+        for (const auto& process : resident)
+        {
+            allocator->deallocate(process);
+        }
+    }
+
+    /**
+     * @brief Replay one allocate/deallocate trace per thread against a shared allocator.
+     * @param name The allocator name.
+     * @param memory_kb Total memory.
+     * @param frame_kb Frame size.
+     * @param num_threads Number of threads.
+     * @param out Stream for the row.
+     */
+    void benchContention(const std::string& name, size_t memory_kb, size_t frame_kb, int num_threads, std::ostream& out)
+    {
+        std::unique_ptr<IMemoryAllocator> allocator = AllocatorRegistry::create(name, memory_kb, frame_kb);
+        std::vector<std::vector<TraceOp>> traces;
+        for (int t = 0; t < num_threads; ++t)
+        {
+            traces.push_back(makeTrace(100 + t, THREAD_OPS, memory_kb, frame_kb, 1 + t * THREAD_OPS, false));
+        }
+
+        std::atomic<bool> go = false;
+        std::atomic<bool> release = false;
+        std::atomic<int> ready = 0;
+        std::atomic<int> finished = 0;
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < num_threads; ++t)
+        {
+            threads.emplace_back([&, t]()
+            {
+                std::vector<std::shared_ptr<Process>> resident;
+                ready++;
+                while (!go)
+                {
+                    std::this_thread::yield();
+                }
+
+                for (TraceOp& op : traces[t])
+                {
+                    if (op.type == ALLOCATE)
+                    {
+                        void* memory = allocator->allocate(op.process);
+                        if (memory)
+                        {
+                            op.process->setMemory(memory);
+                            resident.push_back(op.process);
+                        }
+                    }
+                    else if (!resident.empty())
+                    {
+                        size_t index = op.pick % resident.size();
+                        allocator->deallocate(resident[index]);
+                        resident[index]->setMemory(nullptr);
+                        resident[index] = resident.back();
+                        resident.pop_back();
+                    }
+                }
+
+                // Stay put until the counters are read, so cleanup is not counted
+                finished++;
+                while (!release)
+                {
+                    std::this_thread::yield();
+                }
+                for (const auto& process : resident)
+                {
+                    allocator->deallocate(process);
+                }
+            });
+        }
+
+        while (ready < num_threads)
+        {
+            std::this_thread::yield();
+        }
+        LockStats before = allocator->getLockStats();
+        auto start = std::chrono::steady_clock::now();
+        go = true;
+        while (finished < num_threads)
+        {
+            std::this_thread::yield();
+        }
+        long long wall = nanosSince(start);
+        LockStats after = allocator->getLockStats();
+
+        release = true;
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        long long ops = static_cast<long long>(num_threads) * THREAD_OPS;
+        long long acquisitions = after.acquisitions - before.acquisitions;
+        long long contended = after.contended - before.contended;
+        out << name << "," << memory_kb << "," << frame_kb << "," << num_threads << "," << ops << std::fixed << std::setprecision(0)
+            << "," << ops * 1e9 / wall << "," << std::setprecision(1) << static_cast<double>(wall) * num_threads / ops
+            << "," << acquisitions << "," << (acquisitions > 0 ? 100.0 * contended / acquisitions : 0.0)
+            << "," << (acquisitions > 0 ? static_cast<double>(after.hold_ns - before.hold_ns) / acquisitions : 0.0)
+            << "," << after.max_hold_ns << std::endl;
+    }
+}
+
+/**
+ * @brief Prints the ns/op, fragmentation curve and contention tables for every registered allocator.
+ * @return 0 on successful execution.
+ */
+int main()
+{
+    std::vector<std::string> names = AllocatorRegistry::names();
+
+    std::cout << "allocator,memory_kb,frame_kb,op,calls,ns_per_op" << std::endl;
+    std::ostringstream curve;
+    curve << "allocator,memory_kb,frame_kb,ops,resident,free_kb,alloc_failures,fragmented_failures" << std::endl;
+    for (const std::string& name : names)
+    {
+        for (const auto& [memory_kb, frame_kb] : MEMORY_SIZES)
+        {
+            benchSingle(name, memory_kb, frame_kb, std::cout, curve);
+        }
+    }
+    std::cout << std::endl << curve.str() << std::endl;
+
+    std::cout << "allocator,memory_kb,frame_kb,threads,ops,ops_per_sec,ns_per_op,lock_acquisitions,contended_pct,mean_hold_ns,max_hold_ns" << std::endl;
+    for (const std::string& name : names)
+    {
+        for (const auto& [memory_kb, frame_kb] : MEMORY_SIZES)
+        {
+            for (int threads = 1; threads <= MAX_THREADS; threads *= 2)
+            {
+                benchContention(name, memory_kb, frame_kb, threads, std::cout);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "../Clock.h"
+#include "../Process.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file BatchBench.cpp
+ * @brief Measures instructions per second per core with and without batched execution.
+ *
+ * Each simulated core runs PRINT-only processes on the virtual clock with delay-per-exec 0,
+ * one quantum at a time, the way Scheduler::schedule does. Single-step execution waits for
+ * every tick and opens the process log for every PRINT; batched execution waits once per
+ * quantum and writes the quantum's output in one go.
+ */
+
+namespace
+{
+    constexpr int INSTRUCTIONS_PER_PROCESS = 1000;
+    constexpr auto RUN_TIME = std::chrono::milliseconds(1000);
+
+    /**
+     * @brief Runs num_cores cores against the virtual clock for RUN_TIME.
+     * @param num_cores Number of simulated cores.
+     * @param quantum Instructions per quantum.
+     * @param batched Whether to use Process::executeCommands.
+     * @return Instructions per second per core.
+     */
+    double bench(int num_cores, int quantum, bool batched)
+    {
+        Clock clock(Clock::VIRTUAL);
+        std::atomic<bool> done = false;
+        std::atomic<long long> instructions = 0;
+        std::vector<std::thread> cores;
+
+        clock.startCpuClock();
+        auto start = std::chrono::steady_clock::now();
+        for (int core = 1; core <= num_cores; ++core)
+        {
+            cores.emplace_back([&, core]()
+            {
+                int slot = clock.registerParticipant();
+                int last = clock.getCpuClock();
+                long long local = 0;
+                std::string name = "batch_bench_core_" + std::to_string(core);
+
+                while (!done)
+                {
+                    Process process(core, name, "", core, INSTRUCTIONS_PER_PROCESS, INSTRUCTIONS_PER_PROCESS, 0, 1);
+                    process.generateCommands(INSTRUCTIONS_PER_PROCESS);
+
+                    while (!done && process.getCommandCounter() < process.getLinesOfCode())
+                    {
+                        if (batched)
+                        {
+                            int count = std::min(quantum, process.getLinesOfCode() - process.getCommandCounter());
+                            last = clock.waitUntil(slot, last + count);
+                            local += process.executeCommands(count);
+                        }
+                        else
+                        {
+                            for (int i = 0; i < quantum && process.getCommandCounter() < process.getLinesOfCode(); ++i)
+                            {
+                                last = clock.waitUntil(slot, last + 1);
+                                process.executeCurrentCommand();
+                                local++;
+                            }
+                        }
+                    }
+                }
+
+                instructions += local;
+                clock.unregisterParticipant(slot);
+                std::remove((name + ".txt").c_str());
+            });
+        }
+
+        std::this_thread::sleep_for(RUN_TIME);
+        done = true;
+        for (auto& core : cores)
+        {
+            core.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        clock.stopCpuClock();
+
+        return instructions.load() / seconds / num_cores;
+    }
+}
+
+/**
+ * @brief Prints a CSV table of instructions per second per core for several quanta and core counts.
+ * @return 0 on successful execution.
+ */
+int main()
+{
+    std::cout << "cores,quantum,single_ips_per_core,batched_ips_per_core" << std::endl;
+    for (int cores = 1; cores <= 8; cores *= 2)
+    {
+        for (int quantum : {4, 16, 64})
+        {
+            double single = bench(cores, quantum, false);
+            double batched = bench(cores, quantum, true);
+            std::cout << cores << "," << quantum << "," << std::fixed << std::setprecision(0)
+                      << single << "," << batched << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,355 @@
+#include "../CpuAffinity.h"
+#include "../EmulatorConfig.h"
+#include "../ProcessManager.h"
+#include "../RunLog.h"
+#include "../Tracer.h"
+#include "../WorkloadTrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @file HeadlessBench.cpp
+ * @brief Runs the scheduler-test workload without the console and prints one CSV row per run.
+ *
+ * Usage: headless_bench [--config FILE] [--processes N] [--ticks T] [--cpus LIST] [--quanta LIST]
+ *                       [--max-seconds S] [--workload TRACE] [--record LOG | --replay LOG]
+ *
+ * Each run builds a fresh clock and ProcessManager from the config file and generates a process
+ * every batch-process-freq ticks, like scheduler-test. A run ends once N processes have finished
+ * (default 1000), after T ticks, or after S seconds of host time (default 60), whichever comes
+ * first; --processes 0 generates processes until the tick limit. With --workload the processes
+ * come from a workload trace instead (see WorkloadTrace), and a run ends once every process in it
+ * has finished. --cpus and --quanta take comma-separated lists and sweep every combination;
+ * without them the config values are used. Use clock-mode "virtual" in the config for repeatable
+ * results.
+ *
+ * --record writes every scheduling decision and allocation outcome of a single run to a run log
+ * (see RunLog). --replay runs the arrivals of such a log again and holds every decision to the
+ * recording, so two builds can be timed on exactly the same run; whether the replay matched is
+ * printed to stderr.
+ */
+
+namespace
+{
+    /**
+     * @struct Options
+     * @brief Command-line settings.
+     */
+    struct Options
+    {
+        std::string config_path = "config.txt";
+        int processes = 1000;
+        int ticks = 0;
+        int max_seconds = 60;
+        std::string workload;
+        std::string record;
+        std::string replay;
+        std::vector<int> cpus;
+        std::vector<int> quanta;
+    };
+
+    /**
+     * @brief Parse a comma-separated list of positive numbers.
+     * @param text The list, e.g. "1,2,4".
+     * @param values Receives the numbers.
+     * @return False if an entry is not a positive number.
+     */
+    bool parseList(const std::string& text, std::vector<int>& values)
+    {
+        std::istringstream stream(text);
+        for (std::string entry; std::getline(stream, entry, ',');)
+        {
+            int value = std::atoi(entry.c_str());
+            if (value <= 0)
+            {
+                return false;
+            }
+            values.push_back(value);
+        }
+        return !values.empty();
+    }
+
+    /**
+     * @brief Run the workload once and print its CSV row.
+     * @param config The settings; num_cpu and quantum_cycles are those of this run.
+     * @param options The stop conditions.
+     * @param csv Stream to print the row to.
+     */
+    void runOnce(const EmulatorConfig& config, const Options& options, std::ostream& csv)
+    {
+        Clock clock(config.clock_mode == "virtual" ? Clock::VIRTUAL : Clock::REAL, config.tickless_idle != 0);
+        clock.startCpuClock();
+
+        // Outlives the ProcessManager, so the last decisions are in before it is reported
+        RunLog run_log;
+        bool replay_run = !options.replay.empty();
+        if (replay_run ? !run_log.replay(options.replay, config.describeRun(), &clock)
+                       : !options.record.empty() && !run_log.record(options.record, config.describeRun(), &clock))
+        {
+            clock.stopCpuClock();
+            return;
+        }
+        bool logged = replay_run || !options.record.empty();
+
+        int created = 0;
+        bool timed_out = false;
+        auto wall_start = std::chrono::steady_clock::now();
+        {
+            ProcessManager process_manager(config.min_ins, config.max_ins, config.num_cpu, config.scheduler, config.delays_per_exec,
+                                           config.quantum_cycles, &clock, config.max_mem, config.mem_per_frame, config.min_mem_per_proc,
+                                           config.max_mem_per_proc, config.context_switch_ticks, config.migration_cost_ticks,
+                                           config.policy_config, config.seed, logged ? &run_log : nullptr);
+            const Scheduler& scheduler = process_manager.getScheduler();
+
+            // The generator is a clock participant, so on the virtual clock time cannot pass a stop
+            // check before it has been made
+            int slot = clock.registerParticipant();
+            int start = clock.getCpuClock();
+            int step = std::max(config.batch_process_freq, 1);
+            int end = options.ticks > 0 ? start + options.ticks : -1;
+            int tick = start;
+
+            // Each run replays the trace from the start, reading it as it goes. A replayed run
+            // takes its arrivals from the run log instead; the first one is admitted on the first
+            // tick waited for, and the rest are timed from it.
+            WorkloadTrace trace;
+            std::function<bool(WorkloadTrace::Record&)> next;
+            int origin = start;
+            if (replay_run)
+            {
+                next = [&run_log](WorkloadTrace::Record& record) { return run_log.nextArrival(record); };
+                origin = start + 1;
+            }
+            else if (!options.workload.empty() && trace.open(options.workload))
+            {
+                next = [&trace](WorkloadTrace::Record& record) { return trace.next(record); };
+            }
+
+            WorkloadTrace::Record record;
+            bool replay = replay_run || !options.workload.empty();
+            bool pending = next && next(record);
+
+            while (true)
+            {
+                int target = pending ? std::max(origin + record.arrival_tick, tick + 1) : tick + step;
+                tick = clock.waitUntil(slot, end >= 0 ? std::min(target, end) : target);
+
+                if (end >= 0 && tick >= end)
+                {
+                    break;
+                }
+                if (replay ? !pending && scheduler.getFinishedProcesses() >= created
+                           : options.processes > 0 && scheduler.getFinishedProcesses() >= options.processes)
+                {
+                    break;
+                }
+                if (std::chrono::steady_clock::now() - wall_start >= std::chrono::seconds(options.max_seconds))
+                {
+                    timed_out = true;
+                    break;
+                }
+
+                if (replay)
+                {
+                    for (; pending && origin + record.arrival_tick <= tick; pending = next(record))
+                    {
+                        if (!process_manager.addProcess("bench_" + std::to_string(created), "", record))
+                        {
+                            std::cerr << "Error: A workload process needs " << record.memory_kb << " KB but memory is only "
+                                      << config.max_mem << " KB. Skipped." << std::endl;
+                            continue;
+                        }
+                        created++;
+                    }
+                }
+                else if (options.processes == 0 || created < options.processes)
+                {
+                    process_manager.addProcess("bench_" + std::to_string(created), "", 0);
+                    created++;
+                }
+            }
+
+            // Read everything while the clock is still held at this tick
+            double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+            int elapsed = std::max(tick - start, 1);
+            long long busy_ticks = 0;
+            long long context_switches = 0;
+            long long migrations = 0;
+            for (int core_id = 1; core_id <= scheduler.getCoreSlots(); ++core_id)
+            {
+                busy_ticks += scheduler.getCoreLoad(core_id).getBusyTicks(tick);
+                context_switches += scheduler.getCoreLoad(core_id).getContextSwitches();
+                migrations += scheduler.getCoreLoad(core_id).getMigrations();
+            }
+
+            const SchedulingMetrics& metrics = scheduler.getMetrics();
+            IMemoryAllocator& memory = process_manager.getMemoryAllocator();
+            long long finished = metrics.getFinished();
+
+            csv << config.scheduler << "," << config.num_cpu << "," << config.quantum_cycles << "," << created << "," << finished
+                << "," << elapsed << "," << std::fixed << std::setprecision(3) << wall_seconds
+                << "," << std::setprecision(2) << 1000.0 * finished / elapsed << "," << finished / wall_seconds
+                << "," << std::setprecision(4) << static_cast<double>(busy_ticks) / (static_cast<long long>(elapsed) * config.num_cpu)
+                << "," << std::setprecision(1) << metrics.getWait().mean() << "," << metrics.getResponse().mean()
+                << "," << metrics.getResponse().percentile(0.50) << "," << metrics.getResponse().percentile(0.99)
+                << "," << metrics.getTurnaround().percentile(0.50) << "," << metrics.getTurnaround().percentile(0.99)
+                << "," << context_switches << "," << migrations << "," << metrics.getPreemptions()
+                << "," << scheduler.getMemoryStallTicks() << "," << memory.getPageIn() << "," << memory.getPageOut()
+                << "," << memory.getMaxMemory() - memory.getExternalFragmentation() << "," << memory.getExternalFragmentation()
+                << "," << (timed_out ? 1 : 0) << std::endl;
+
+            clock.unregisterParticipant(slot);
+        }
+        clock.stopCpuClock();
+        if (logged)
+        {
+            run_log.close();
+            run_log.report(std::cerr);
+        }
+
+        for (int i = 0; i < created; ++i)
+        {
+            std::remove(("bench_" + std::to_string(i) + ".txt").c_str());
+        }
+    }
+}
+
+/**
+ * @brief Parses the options, then runs every num-cpu and quantum-cycles combination.
+ * @param argc Number of arguments.
+ * @param argv The arguments.
+ * @return 0 on success, 1 on a bad option or config file.
+ */
+int main(int argc, char* argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Error: Missing value for " << option << "." << std::endl;
+            return 1;
+        }
+
+        std::string value = argv[++i];
+        bool valid = true;
+        if (option == "--config")
+        {
+            options.config_path = value;
+        }
+        else if (option == "--processes")
+        {
+            options.processes = std::atoi(value.c_str());
+            valid = options.processes >= 0;
+        }
+        else if (option == "--ticks")
+        {
+            options.ticks = std::atoi(value.c_str());
+            valid = options.ticks >= 0;
+        }
+        else if (option == "--max-seconds")
+        {
+            options.max_seconds = std::atoi(value.c_str());
+            valid = options.max_seconds > 0;
+        }
+        else if (option == "--workload")
+        {
+            options.workload = value;
+            valid = WorkloadTrace().open(value);
+        }
+        else if (option == "--record")
+        {
+            options.record = value;
+        }
+        else if (option == "--replay")
+        {
+            options.replay = value;
+            valid = std::ifstream(value).is_open();
+        }
+        else if (option == "--cpus")
+        {
+            valid = parseList(value, options.cpus) && *std::max_element(options.cpus.begin(), options.cpus.end()) <= Scheduler::MAX_CORES;
+        }
+        else if (option == "--quanta")
+        {
+            valid = parseList(value, options.quanta);
+        }
+        else
+        {
+            std::cerr << "Error: Unknown option " << option << "." << std::endl;
+            return 1;
+        }
+
+        if (!valid)
+        {
+            std::cerr << "Error: Invalid value '" << value << "' for " << option << "." << std::endl;
+            return 1;
+        }
+    }
+
+    if (options.processes == 0 && options.ticks == 0 && options.workload.empty() && options.replay.empty())
+    {
+        std::cerr << "Error: --processes 0 needs a --ticks limit." << std::endl;
+        return 1;
+    }
+
+    bool logged = !options.record.empty() || !options.replay.empty();
+    if (logged && ((!options.record.empty() && !options.replay.empty()) || !options.workload.empty() || options.cpus.size() > 1 || options.quanta.size() > 1))
+    {
+        std::cerr << "Error: --record and --replay take a single run, without --workload." << std::endl;
+        return 1;
+    }
+
+    EmulatorConfig config;
+    if (!config.load(options.config_path))
+    {
+        std::cerr << "Error: Unable to open config file " << options.config_path << "." << std::endl;
+        return 1;
+    }
+
+    Tracer::setEnabled(config.trace != 0);
+    CpuAffinity::getInstance().configure(config.cpu_affinity, config.housekeeping_cpus);
+    CpuAffinity::getInstance().pinHousekeeping();
+
+    if (options.cpus.empty())
+    {
+        options.cpus.push_back(config.num_cpu);
+    }
+    if (options.quanta.empty())
+    {
+        options.quanta.push_back(config.quantum_cycles);
+    }
+
+    // The emulator prints banners and warnings to std::cout; keep them out of the CSV
+    std::streambuf* console = std::cout.rdbuf(nullptr);
+    std::ostream csv(console);
+
+    csv << "scheduler,num_cpu,quantum,created,finished,ticks,wall_s,finished_per_1k_ticks,finished_per_s,cpu_util,"
+        << "wait_mean,response_mean,response_p50,response_p99,turnaround_p50,turnaround_p99,"
+        << "context_switches,migrations,preemptions,memory_stall_ticks,pages_in,pages_out,used_kb,free_kb,timed_out" << std::endl;
+
+    for (int cpus : options.cpus)
+    {
+        for (int quantum : options.quanta)
+        {
+            config.num_cpu = cpus;
+            config.quantum_cycles = quantum;
+            runOnce(config, options, csv);
+        }
+    }
+
+    std::cout.rdbuf(console);
+    std::cout.clear();
+    return 0;
+}
@@ -0,0 +1,241 @@
+#include "../MpmcQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file QueueBench.cpp
+ * @brief Measures ready-queue contention between the process generator and many cores.
+ *
+ * One producer admits a new process as fast as batch-process-freq 1 allows in virtual time, i.e.
+ * back to back, while every core pops a process, runs a short quantum and pushes it back until
+ * it finishes. This is the pattern the scheduler-test generator and the RR cores produce. The
+ * lock-free admission ring is compared against the previous mutex + condition_variable queue.
+ */
+
+namespace
+{
+    /**
+     * @struct FakeProcess
+     * @brief Stand-in for Process; only the remaining quanta matter here.
+     */
+    struct FakeProcess
+    {
+        int quanta_left = 0; ///< Quanta to run before finishing.
+    };
+
+    using ProcessPtr = std::shared_ptr<FakeProcess>;
+
+    constexpr size_t QUEUE_CAPACITY = 1024;
+
+    /**
+     * @class LockedQueue
+     * @brief Replica of the mutex + condition_variable ready queue, kept for comparison.
+     * Bounded like the ring so both runs hold the same number of processes.
+     */
+    class LockedQueue
+    {
+    public:
+        bool tryPush(ProcessPtr& process)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (queue_.size() >= QUEUE_CAPACITY)
+                {
+                    return false;
+                }
+                queue_.push_back(std::move(process));
+            }
+            condition_.notify_one();
+            return true;
+        }
+
+        bool pop(ProcessPtr& process, const std::atomic<bool>& done)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [&] { return !queue_.empty() || done; });
+            if (queue_.empty())
+            {
+                return false;
+            }
+            process = std::move(queue_.front());
+            queue_.pop_front();
+            return true;
+        }
+
+        void wakeAll()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            condition_.notify_all();
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        std::deque<ProcessPtr> queue_;
+    };
+
+    /**
+     * @class RingQueue
+     * @brief The admission ring with the scheduler's blocking fallback for idle cores.
+     */
+    class RingQueue
+    {
+    public:
+        RingQueue() : ring_(QUEUE_CAPACITY) {}
+
+        bool tryPush(ProcessPtr& process)
+        {
+            if (!ring_.tryPush(process))
+            {
+                return false;
+            }
+
+            // Only touch the lock when a core is actually asleep
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (idle_waiters_.load() > 0)
+            {
+                std::lock_guard<std::mutex> lock(idle_mutex_);
+                idle_condition_.notify_one();
+            }
+            return true;
+        }
+
+        bool pop(ProcessPtr& process, const std::atomic<bool>& done)
+        {
+            while (!ring_.tryPop(process))
+            {
+                std::unique_lock<std::mutex> lock(idle_mutex_);
+                idle_waiters_++;
+                idle_condition_.wait(lock, [&] { return ring_.sizeApprox() > 0 || done; });
+                idle_waiters_--;
+                if (done)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void wakeAll()
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex_);
+            idle_condition_.notify_all();
+        }
+
+    private:
+        MpmcQueue<ProcessPtr> ring_;
+        std::atomic<int> idle_waiters_{0};
+        std::mutex idle_mutex_;
+        std::condition_variable idle_condition_;
+    };
+
+    constexpr auto RUN_TIME = std::chrono::milliseconds(500);
+    constexpr int QUANTA_PER_PROCESS = 8;
+    constexpr int WORK_PER_QUANTUM = 200;
+
+    /**
+     * @struct Result
+     * @brief Throughput of one run.
+     */
+    struct Result
+    {
+        double admissions_per_sec; ///< Processes added by the producer.
+        double dispatches_per_sec; ///< Quanta started by the cores.
+    };
+
+    /**
+     * @brief Runs one producer and num_cores consumers against a queue.
+     * @return Admission and dispatch rates.
+     */
+    template <typename Queue>
+    Result bench(int num_cores)
+    {
+        Queue queue;
+        std::atomic<bool> done = false;
+        std::atomic<long long> dispatches = 0;
+        long long admissions = 0;
+        std::vector<std::thread> cores;
+
+        for (int i = 0; i < num_cores; ++i)
+        {
+            cores.emplace_back([&]()
+            {
+                ProcessPtr process;
+                long long local = 0;
+                volatile int sink = 0;
+
+                while (queue.pop(process, done))
+                {
+                    local++;
+                    for (int w = 0; w < WORK_PER_QUANTUM; ++w)
+                    {
+                        sink = sink + w;
+                    }
+
+                    if (--process->quanta_left > 0)
+                    {
+                        while (!queue.tryPush(process) && !done)
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                    process.reset();
+                }
+                dispatches += local;
+            });
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        auto end = start + RUN_TIME;
+        while (std::chrono::steady_clock::now() < end)
+        {
+            ProcessPtr process = std::make_shared<FakeProcess>();
+            process->quanta_left = QUANTA_PER_PROCESS;
+            if (queue.tryPush(process))
+            {
+                admissions++;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        done = true;
+        queue.wakeAll();
+        for (auto& core : cores)
+        {
+            core.join();
+        }
+
+        return {admissions / seconds, dispatches.load() / seconds};
+    }
+}
+
+/**
+ * @brief Prints a CSV table of admission and dispatch rates for 1 to 128 simulated cores.
+ * @return 0 on successful execution.
+ */
+int main()
+{
+    std::cout << "cores,ring_admits_per_sec,ring_dispatches_per_sec,locked_admits_per_sec,locked_dispatches_per_sec" << std::endl;
+    for (int cores = 1; cores <= 128; cores *= 2)
+    {
+        Result ring = bench<RingQueue>(cores);
+        Result locked = bench<LockedQueue>(cores);
+        std::cout << cores << "," << std::fixed << std::setprecision(0)
+                  << ring.admissions_per_sec << "," << ring.dispatches_per_sec << ","
+                  << locked.admissions_per_sec << "," << locked.dispatches_per_sec << std::endl;
+    }
+    return 0;
+}
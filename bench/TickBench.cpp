@@ -0,0 +1,219 @@
+#include "../Clock.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+/**
+ * @file TickBench.cpp
+ * @brief Measures virtual-clock ticks per second against the number of simulated cores.
+ *
+ * Every simulated core waits for each tick in turn, which is the worst case for tick delivery.
+ * The per-slot Clock is compared against a replica of the previous design, where all waiters
+ * shared one mutex and condition variable and every tick was a notify_all.
+ */
+
+namespace
+{
+    /**
+     * @class BroadcastClock
+     * @brief Replica of the mutex + condition_variable virtual clock, kept for comparison.
+     */
+    class BroadcastClock
+    {
+    public:
+        void start()
+        {
+            running_ = true;
+            thread_ = std::thread([this]()
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                while (running_)
+                {
+                    advance_.wait(lock, [this]
+                    {
+                        return !running_ || (parked_ == participants_ && !pending_.empty());
+                    });
+                    if (!running_)
+                    {
+                        break;
+                    }
+
+                    int next = std::max(*pending_.begin(), clock_ + 1);
+                    while (!pending_.empty() && *pending_.begin() <= next)
+                    {
+                        pending_.erase(pending_.begin());
+                        parked_--;
+                    }
+                    clock_ = next;
+                    tick_.notify_all();
+                }
+            });
+        }
+
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                running_ = false;
+            }
+            advance_.notify_all();
+            tick_.notify_all();
+            thread_.join();
+        }
+
+        void registerParticipant()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            participants_++;
+        }
+
+        void unregisterParticipant()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            participants_--;
+            advance_.notify_one();
+        }
+
+        int waitUntil(int tick)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            pending_.insert(tick);
+            if (++parked_ == participants_)
+            {
+                advance_.notify_one();
+            }
+            tick_.wait(lock, [&] { return clock_ >= tick || !running_; });
+            return clock_;
+        }
+
+        int getCpuClock()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return clock_;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable tick_;
+        std::condition_variable advance_;
+        std::multiset<int> pending_;
+        std::thread thread_;
+        int clock_ = 0;
+        int participants_ = 0;
+        int parked_ = 0;
+        bool running_ = false;
+    };
+
+    constexpr auto RUN_TIME = std::chrono::milliseconds(500);
+
+    /**
+     * @brief Runs num_cores waiters against the per-slot Clock.
+     * @return Ticks per second.
+     */
+    double benchSlotClock(int num_cores)
+    {
+        Clock clock(Clock::VIRTUAL);
+        std::atomic<bool> done = false;
+        std::vector<std::thread> cores;
+
+        clock.startCpuClock();
+        for (int i = 0; i < num_cores; ++i)
+        {
+            cores.emplace_back([&]()
+            {
+                int slot = clock.registerParticipant();
+                int last = clock.getCpuClock();
+                while (!done)
+                {
+                    last = clock.waitUntil(slot, last + 1);
+                }
+                clock.unregisterParticipant(slot);
+            });
+        }
+
+        int start_tick = clock.getCpuClock();
+        auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(RUN_TIME);
+        int end_tick = clock.getCpuClock();
+        auto end = std::chrono::steady_clock::now();
+
+        done = true;
+        for (auto& core : cores)
+        {
+            core.join();
+        }
+        clock.stopCpuClock();
+
+        return (end_tick - start_tick) / std::chrono::duration<double>(end - start).count();
+    }
+
+    /**
+     * @brief Runs num_cores waiters against the broadcast replica.
+     * @return Ticks per second.
+     */
+    double benchBroadcastClock(int num_cores)
+    {
+        BroadcastClock clock;
+        std::atomic<bool> done = false;
+        std::vector<std::thread> cores;
+
+        clock.start();
+        for (int i = 0; i < num_cores; ++i)
+        {
+            cores.emplace_back([&]()
+            {
+                clock.registerParticipant();
+                int last = clock.getCpuClock();
+                while (!done)
+                {
+                    last = clock.waitUntil(last + 1);
+                }
+                clock.unregisterParticipant();
+            });
+        }
+
+        int start_tick = clock.getCpuClock();
+        auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(RUN_TIME);
+        int end_tick = clock.getCpuClock();
+        auto end = std::chrono::steady_clock::now();
+
+        done = true;
+        for (auto& core : cores)
+        {
+            core.join();
+        }
+        clock.stop();
+
+        return (end_tick - start_tick) / std::chrono::duration<double>(end - start).count();
+    }
+}
+
+/**
+ * @brief Prints a CSV table of ticks per second for 1 to 128 simulated cores.
+ * @return 0 on successful execution.
+ */
+int main()
+{
+    // Clock prints start/stop banners; keep them out of the CSV
+    std::streambuf* banner = std::cout.rdbuf(nullptr);
+    std::ostream csv(banner);
+
+    csv << "cores,slot_ticks_per_sec,broadcast_ticks_per_sec" << std::endl;
+    for (int cores = 1; cores <= 128; cores *= 2)
+    {
+        double slot = benchSlotClock(cores);
+        double broadcast = benchBroadcastClock(cores);
+        csv << cores << "," << std::fixed << std::setprecision(0) << slot << "," << broadcast << std::endl;
+    }
+
+    std::cout.rdbuf(banner);
+    return 0;
+}
@@ -1,2 +1,8 @@
 #!/usr/bin/env bash
 i686-w64-mingw32-c++ -static -static-libgcc -static-libstdc++ -Wall -Wextra -std=c++20 ./*.cpp  -o main.exe
+i686-w64-mingw32-c++ -static -static-libgcc -static-libstdc++ -Wall -Wextra -std=c++20 ./bench/TickBench.cpp ./Clock.cpp ./CpuAffinity.cpp -o tick_bench.exe
+i686-w64-mingw32-c++ -static -static-libgcc -static-libstdc++ -Wall -Wextra -std=c++20 ./bench/QueueBench.cpp -o queue_bench.exe
+i686-w64-mingw32-c++ -static -static-libgcc -static-libstdc++ -Wall -Wextra -std=c++20 ./bench/BatchBench.cpp ./Process.cpp ./Clock.cpp ./CpuAffinity.cpp -o batch_bench.exe
+i686-w64-mingw32-c++ -static -static-libgcc -static-libstdc++ -Wall -Wextra -std=c++20 ./bench/HeadlessBench.cpp $(ls ./*.cpp | grep -v '/Main.cpp$') -o headless_bench.exe
+i686-w64-mingw32-c++ -static -static-libgcc -static-libstdc++ -Wall -Wextra -std=c++20 ./bench/AllocatorBench.cpp ./IMemoryAllocator.cpp ./FlatMemoryAllocator.cpp ./PagingAllocator.cpp ./Process.cpp -o allocator_bench.exe
+i686-w64-mingw32-c++ -static -static-libgcc -static-libstdc++ -Wall -Wextra -std=c++20 ./bench/AccountingCheck.cpp $(ls ./*.cpp | grep -v '/Main.cpp$') -o accounting_check.exe